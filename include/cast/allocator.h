@@ -1,6 +1,8 @@
 #ifndef ALLOCATOR_H
 #define ALLOCATOR_H
 
+#include <stdbool.h>
+
 #ifdef __CAST_MANAGED__
 #define BEGIN_MANAGED __managed {
 #define END_MANAGED }
@@ -13,9 +15,20 @@
 
 typedef struct Allocator_ Allocator;
 void *allocator_new();
+void *allocator_new_mapped(long size);
 void allocator_delete(Allocator *a);
+void allocator_reset(Allocator *a);
 void *allocator_memalloc(Allocator *a, int size);
 char *allocator_strdup(Allocator *a, const char *s);
+/* bytes in use, and the most in use since the allocator was made or
+   allocator_reset_peak() */
+long allocator_used(Allocator *a);
+long allocator_peak(Allocator *a);
+void allocator_reset_peak(Allocator *a);
+/* allocations past the limit (0 for none) still succeed; users check
+   allocator_over_limit() where they can stop */
+void allocator_set_limit(Allocator *a, long bytes);
+bool allocator_over_limit(Allocator *a);
 
 typedef struct {
 	Allocator *allocator;
@@ -1,10 +1,15 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include <stdbool.h>
+
 typedef struct TextStream_ TextStream;
+typedef struct Allocator_ Allocator;
 
 TextStream *text_stream_new(const char *file);
-TextStream *text_stream_from_string(const char *string);
+TextStream *text_stream_from_string(const char *string, Allocator *a);
+// len bytes at buf, which must outlive the stream
+TextStream *text_stream_from_buffer(const char *buf, long len);
 void text_stream_delete(TextStream *ts);
 char text_stream_peek(TextStream *ts);
 void text_stream_next(TextStream *ts);
@@ -124,18 +129,65 @@ enum {
 	TOK_MANAGED = 16384,
 };
 
-Lexer *lexer_new(TextStream *ts);
+// identifiers the parser gives their own syntax
+enum {
+	BUILTIN_NONE,
+	BUILTIN_VA_START,
+	BUILTIN_VA_ARG,
+	BUILTIN_VA_END,
+	BUILTIN_OFFSETOF,
+	BUILTIN_TYPES_COMPATIBLE_P,
+	BUILTIN_TYPENAME,
+};
+
+Lexer *lexer_new(TextStream *ts, Allocator *a);
 void lexer_delete(Lexer *l);
 void lexer_next(Lexer *l);
 int lexer_peek(Lexer *l);
 const char *lexer_peek_string(Lexer *l);
 int lexer_peek_string_len(Lexer *l);
+// in-place contents of an unescaped string literal (not NUL-terminated,
+// valid as long as the TextStream), or NULL
+const char *lexer_peek_string_ref(Lexer *l);
+// interned spelling of an identifier or keyword, or NULL without an allocator
+const char *lexer_peek_ident(Lexer *l);
+// BUILTIN_* of an identifier, looked up when it was interned
+int lexer_peek_builtin(Lexer *l);
 unsigned long long lexer_peek_uint(Lexer *l);
 double lexer_peek_float(Lexer *l);
 char lexer_peek_char(Lexer *l);
 
+/* position of the current token, for lexer_rewind().  Tokens after a
+   rewind are lexed again: the parser looks one token ahead and goes back
+   only to pass an item through or to parse a lazy body, so keeping all
+   tokens in an array would cost more than lexing twice. */
+typedef struct {
+	long off;
+	int line;
+} LexerMark;
+LexerMark lexer_mark(Lexer *l);
+void lexer_rewind(Lexer *l, LexerMark m);
+/* lexer_rewind() to a token of the given file.  Only needed while
+   streaming, where the path comes from the line markers read last. */
+void lexer_rewind_path(Lexer *l, LexerMark m, const char *path, int flags);
+// input text from the marked token to the end of the last one passed
+const char *lexer_text_since(Lexer *l, LexerMark m, long *len);
+// the current token becomes TOK_END, as if the input ended here
+void lexer_skip_to_end(Lexer *l);
+// the whole input text
+const char *lexer_input(Lexer *l, long *len);
+// tokens lexed so far; going back and lexing again counts again
+long lexer_token_count(Lexer *l);
+
 const char *lexer_report_path(Lexer *l);
 int lexer_report_line(Lexer *l);
+// the current token comes from a header the line markers flag as system
+bool lexer_in_system_header(Lexer *l);
+// LINE_SYSTEM and LINE_EXTERN_C (srcloc.h) of the current token's file
+int lexer_report_flags(Lexer *l);
+/* the file a line marker first entered path from, or NULL for a file
+   that was never entered (the main file); *flags gets those of path */
+const char *lexer_includer(Lexer *l, const char *path, int *flags);
 
 const char *lexer_report_file(Lexer *l);
 
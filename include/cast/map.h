@@ -18,6 +18,7 @@ typedef struct map_node_t map_node_t;
 typedef struct {
   map_node_t **buckets;
   unsigned nbuckets, nnodes;
+  struct Allocator_ *allocator;
 } map_base_t;
 
 typedef struct {
@@ -34,6 +35,10 @@ typedef struct {
   memset(m, 0, sizeof(*(m)))
 
 
+#define map_init_alloc(m, a)\
+  ( map_init(m), (m)->base.allocator = (a) )
+
+
 #define map_deinit(m)\
   map_deinit_(&(m)->base)
 
@@ -75,6 +80,7 @@ int map_set_(map_base_t *m, const char *key, int ksize, void *value, int vsize);
 void map_remove_(map_base_t *m, const char *key, int ksize);
 map_iter_t map_iter_(void);
 const char *map_next_(map_base_t *m, map_iter_t *iter);
+long map_probe_count(void);
 
 
 typedef map_t(void*) map_void_t;
@@ -5,13 +5,79 @@
 
 typedef struct Lexer_ Lexer;
 typedef struct Parser_ Parser;
+typedef struct LocTable_ LocTable;
 
-Parser *parser_new(Lexer *l);
+Parser *parser_new(Lexer *l, Allocator *a);
 void parser_delete(Parser *p);
+void parser_set_locations(Parser *p, LocTable *t);
+
+/* with recovery on, a declaration or statement that fails to parse is
+   kept as a STMT_OPAQUE holding its input text, and parsing goes on */
+void parser_set_recovery(Parser *p, bool b);
+
+/* with skimming on, top-level items of system headers are not parsed
+   but kept as a STMT_SKIM with the names they declare and use */
+void parser_set_skim(Parser *p, bool b);
+
+/* with lazy bodies on, function definitions get a body holding just a
+   STMT_LAZY; parse_fundecl_body() parses it on demand.  Needs a parser
+   with an allocator, which must outlive the tree. */
+void parser_set_lazy(Parser *p, bool b);
+
+/* past the token limit (0 for none), or once the parser's allocator
+   or the watched one is over its limit, the input looks ended: parsing
+   fails, or stops early, and parser_over_budget() tells why */
+void parser_set_token_limit(Parser *p, long tokens);
+void parser_watch_allocator(Parser *p, Allocator *a);
+bool parser_over_budget(Parser *p);
+
+typedef struct {
+	const char *path;
+	int line;
+} ParseError;
+
+// the syntax errors recovered from, in input order
+const ParseError *parser_errors(Parser *p, int *count);
+
+// parse_translation_unit() split up for parse_external_decl()
+void parser_begin_unit(Parser *p);
+bool parser_end_of_unit(Parser *p);
+void parser_end_unit(Parser *p);
+
+/* a unit parsed from text that can be parsed again after edits.  Only
+   the external declarations the edits touch are parsed again; the
+   others keep their trees, and the names they declared go into the
+   symbol table without parsing them.  Units are parsed with recovery
+   and skimming on, without locations or lazy bodies.  Every version
+   of the text is kept in the allocator, as the trees point into it. */
+typedef struct ParsedUnit_ ParsedUnit;
+
+typedef struct {
+	long off, len;		// the bytes replaced, in the old text
+	const char *text;	// the bytes in their place
+	long text_len;
+} TextEdit;
+
+StmtBLOCK *parsed_unit_tree(ParsedUnit *u);
+const char *parsed_unit_text(ParsedUnit *u, long *len);
+// the declarations parsed by the last parse or reparse
+int parsed_unit_reparsed(ParsedUnit *u);
+void parsed_unit_delete(ParsedUnit *u);
 
 BEGIN_MANAGED
 
 StmtBLOCK *parse_translation_unit(Parser *p);
+Stmt *parse_external_decl(Parser *p);
+// NULL on a syntax error
+ParsedUnit *parse_unit(const char *text, long len, Allocator *a);
+/* applies edits, in order and not overlapping, and parses again;
+   false on a syntax error, which leaves the unit as it was */
+bool reparse_unit(ParsedUnit *u, const TextEdit *edits, int count);
+/* the statements of s, parsed now if its body was left lazy; NULL
+   without a body or on a syntax error, which leaves the text, or once
+   over budget.  The tokens of the body don't count again against the
+   token limit. */
+StmtBLOCK *parse_fundecl_body(Parser *p, StmtFUNDECL *s);
 
 bool parse_decl(Parser *p, Stmt **);
 Stmt *parse_stmt(Parser *p);
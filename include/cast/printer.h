@@ -4,11 +4,21 @@
 #include "tree.h"
 
 typedef struct Printer_ Printer;
+typedef struct LocTable_ LocTable;
 
 Printer *printer_new();
 void printer_delete(Printer *p);
 
 void printer_set_print_type_annot(Printer *self, bool b);
+void printer_set_minimal_parens(Printer *self, bool b);
+void printer_set_compact(Printer *self, bool b);
+void printer_set_locations(Printer *self, LocTable *t);
 void printer_print_translation_unit(Printer *self, StmtBLOCK *s);
+void printer_print_translation_unit_parallel(Printer *self, StmtBLOCK *s,
+					     int nthreads);
+// one external declaration; the output is finished by printer_delete()
+void printer_print_decl(Printer *self, Stmt *s);
+// bytes printed so far, written out or not
+long printer_output_bytes(Printer *self);
 
 #endif /* PRINTER_H */
@@ -0,0 +1,35 @@
+#ifndef SRCLOC_H
+#define SRCLOC_H
+
+#include <stdbool.h>
+
+typedef struct Allocator_ Allocator;
+typedef struct LocTable_ LocTable;
+
+// flag n of a line marker is bit 1 << n
+enum {
+	LINE_ENTER = 1 << 1,
+	LINE_LEAVE = 1 << 2,
+	LINE_SYSTEM = 1 << 3,
+	LINE_EXTERN_C = 1 << 4,
+};
+
+// source locations of tree nodes, kept outside the nodes themselves
+LocTable *loctable_new(Allocator *a);
+void loctable_delete(LocTable *t);
+// forget all nodes, e.g. before their memory is reused
+void loctable_clear(LocTable *t);
+// the file's id, or -1 if it was not added
+int loctable_find(LocTable *t, const char *path);
+/* adds a file included from the file parent, or -1 for none, with the
+   LINE_SYSTEM and LINE_EXTERN_C flags of its line markers */
+int loctable_add(LocTable *t, const char *path, int parent, int flags);
+// loctable_find(), adding the file without an includer if needed
+int loctable_file(LocTable *t, const char *path);
+const char *loctable_path(LocTable *t, int file);
+int loctable_parent(LocTable *t, int file);
+int loctable_flags(LocTable *t, int file);
+void loctable_set(LocTable *t, const void *node, int file, int line);
+bool loctable_get(LocTable *t, const void *node, int *file, int *line);
+
+#endif /* SRCLOC_H */
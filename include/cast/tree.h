@@ -39,6 +39,8 @@ typedef struct Tree_ {
 		STMT_DECLS,
 		// gcc extensions
 		STMT_ASM,
+		STMT_SKIM,
+		STMT_LAZY,
 
 #undef  EXPR
 #define EXPR(id, ...) EXPR_##id,
@@ -47,6 +49,7 @@ typedef struct Tree_ {
 #define EXPR(id, ...)
 		EXPR_CALL,
 		EXPR_INIT,
+		EXPR_INITPACK,
 		// C11
 		EXPR_GENERIC,
 
@@ -223,6 +226,22 @@ ExprINIT *exprINIT();
 void exprINIT_append(ExprINIT *init, Designator *d, Expr *e);
 END_MANAGED
 
+/* a long initializer list of int constants, or of unsigned int ones,
+   the sign of int constants included.  The values are kept in an array
+   of the narrowest width that holds them. */
+typedef struct ExprINITPACK_ {
+	Expr h;
+	int kind;	// EXPR_INT_CST or EXPR_UINT_CST
+	int width;	// bytes per value: 1, 2 or 4
+	int length;
+	const void *values;
+} ExprINITPACK;
+
+BEGIN_MANAGED
+ExprINITPACK *exprINITPACK(int kind, const int *values, int length);
+END_MANAGED
+long long exprINITPACK_get(ExprINITPACK *e, int i);
+
 typedef struct GENERICPair_ {
 	Type *type; // NULL => default
 	Expr *expr;
@@ -293,6 +312,51 @@ void stmtASM_append_clobber(StmtASM *s, const char *name);
 void stmtASM_append_gotolabels(StmtASM *s, const char *name);
 END_MANAGED
 
+enum {
+	SKIM_TYPEDEF = 1,
+	SKIM_EXTERN  = 2,
+	SKIM_STATIC  = 4,
+	SKIM_FUN     = 8,	// some declarator is a function
+	SKIM_VAR     = 16,	// some declarator is an object
+	SKIM_BODY    = 32,	// a function definition
+};
+
+/* a top-level item of a system header, kept as its text.  The names
+   come from scanning the tokens: defs are the declared identifiers,
+   tags and enumerators, uses the other identifiers. */
+typedef struct StmtSKIM_ {
+	Stmt h;
+	unsigned int flags;
+	const char *text;
+	int len;
+	avec_str_t defs;
+	avec_str_t uses;
+	avec_str_t attrs;
+} StmtSKIM;
+
+BEGIN_MANAGED
+StmtSKIM *stmtSKIM();
+void stmtSKIM_append_def(StmtSKIM *s, const char *name);
+void stmtSKIM_append_use(StmtSKIM *s, const char *name);
+void stmtSKIM_append_attr(StmtSKIM *s, const char *name);
+END_MANAGED
+
+/* a function body not parsed yet, as the only item of its block: the
+   text between the braces and the identifiers in it, except member
+   names.  parse_fundecl_body() parses it when a pass needs it. */
+typedef struct StmtLAZY_ {
+	Stmt h;
+	const char *text;
+	int len;
+	avec_str_t uses;
+	void *resume;	// parser state at the '{'
+} StmtLAZY;
+
+BEGIN_MANAGED
+StmtLAZY *stmtLAZY(void *resume);
+void stmtLAZY_append_use(StmtLAZY *s, const char *name);
+END_MANAGED
+
 struct EnumPair_ {
 	const char *id;
 	Attribute *attr;
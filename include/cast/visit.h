@@ -0,0 +1,66 @@
+#ifndef VISIT_H
+#define VISIT_H
+
+#include "tree.h"
+#include "vec.h"
+
+#define VISIT_KINDS (TYPE_FUN + 1)
+
+// returned by pre hooks
+enum {
+	VISIT_CONTINUE,
+	VISIT_SKIP,	// don't walk the children; the post hook still runs
+	VISIT_STOP,	// leave the walk; no more hooks of this visitor run
+};
+
+typedef struct Visitor_ Visitor;
+typedef int (*VisitPre)(Visitor *v, Tree *h);
+typedef void (*VisitPost)(Visitor *v, Tree *h);
+
+/* All hooks may be NULL.  The hooks for a node kind take precedence
+   over the stmt/expr/type ones.  Children are read after the pre hook,
+   so it may replace them, and are walked in field order.  Attributes
+   are not nodes: the attr hook sees each attribute when the node
+   holding it is entered, and may skip its arguments. */
+struct Visitor_ {
+	VisitPre pre[VISIT_KINDS];
+	VisitPost post[VISIT_KINDS];
+	VisitPre stmt, expr, type;
+	VisitPost stmt_post, expr_post, type_post;
+	int (*attr)(Visitor *v, Attribute *a);
+	void *data;
+};
+
+// false if the walk was stopped
+bool visit(Visitor *v, Tree *h);
+
+#define PASSES_MAX 8
+
+typedef struct {
+	Tree *node;
+	unsigned mask;
+	bool post;
+} VisitFrame;
+
+/* Runs several visitors in one traversal.  At each node the hooks are
+   called in the order the passes were added; a pass that skips a
+   subtree is left out of it while the others go on.  The walk keeps
+   its own stack, so deep trees don't recurse.  Hooks must not call
+   passes_run() on the same manager; use visit() for nested walks. */
+typedef struct {
+	Visitor *passes[PASSES_MAX];
+	int npasses;
+	// the passes having pre and post hooks, by node kind
+	unsigned pre[VISIT_KINDS], post[VISIT_KINDS];
+	unsigned attr;
+	unsigned live;
+	vec_t(VisitFrame) stack;
+} PassManager;
+
+void passes_init(PassManager *pm);
+void passes_deinit(PassManager *pm);
+void passes_add(PassManager *pm, Visitor *v);
+// returns the passes that stopped, as a mask by order of adding
+unsigned passes_run(PassManager *pm, Tree *h);
+
+#endif /* VISIT_H */
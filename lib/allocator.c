@@ -3,34 +3,109 @@
 #include <stdbool.h>
 #include <assert.h>
 #include <string.h>
+#include <stddef.h>
+#include <sys/mman.h>
 
 typedef struct Allocator_ Allocator;
 
 #define ALLOCSIZE 16300
+#define POOLMAX 256
 struct allocpage {
 	struct allocpage *next;
-	unsigned char content[];
+	int size;
+	// allocations keep to 16 bytes, like malloc's
+	_Alignas(16) unsigned char content[];
 };
 
 struct Allocator_ {
 	struct allocpage *pages;
 	int cur;
+
+	// pages kept by allocator_reset() for the next round
+	struct allocpage *pool;
+	int npool;
+
+	// optional backing region, see allocator_new_mapped()
+	unsigned char *region;
+	long region_size;
+	long region_cur;
+
+	// bytes of pages in use, the most ever, and a soft limit on them
+	long used, peak, limit;
 };
 
-static void *allocator_init(Allocator *a)
+static bool page_in_region(Allocator *a, struct allocpage *pg)
+{
+	unsigned char *p = (unsigned char *) pg;
+	return a->region && p >= a->region && p < a->region + a->region_size;
+}
+
+static struct allocpage *page_get(Allocator *a, int size)
+{
+	struct allocpage *pg;
+	if (size <= ALLOCSIZE) {
+		size = ALLOCSIZE;
+		if (a->pool) {
+			pg = a->pool;
+			a->pool = pg->next;
+			a->npool--;
+			return pg;
+		}
+	}
+	long bytes = (sizeof(struct allocpage) + size + 15) / 16 * 16;
+	if (a->region && a->region_cur + bytes <= a->region_size) {
+		pg = (struct allocpage *) (a->region + a->region_cur);
+		a->region_cur += bytes;
+	} else {
+		pg = malloc(bytes);
+	}
+	pg->size = size;
+	return pg;
+}
+
+static void page_put(Allocator *a, struct allocpage *pg)
+{
+	if (page_in_region(a, pg))
+		return;
+	if (pg->size == ALLOCSIZE && a->npool < POOLMAX) {
+		pg->next = a->pool;
+		a->pool = pg;
+		a->npool++;
+	} else {
+		free(pg);
+	}
+}
+
+static void allocator_init(Allocator *a)
 {
-	a->pages = malloc(sizeof(struct allocpage) + ALLOCSIZE);
+	assert(offsetof(struct allocpage, content) % 16 == 0);
+	a->pool = NULL;
+	a->npool = 0;
+	a->region = NULL;
+	a->region_size = 0;
+	a->region_cur = 0;
+	a->pages = page_get(a, ALLOCSIZE);
 	a->pages->next = NULL;
 	a->cur = 0;
+	a->used = a->peak = ALLOCSIZE;
+	a->limit = 0;
 }
 
-static void *allocator_free(Allocator *a)
+static void allocator_free(Allocator *a)
 {
 	for (struct allocpage *i = a->pages; i; ) {
+		struct allocpage *next = i->next;
+		if (!page_in_region(a, i))
+			free(i);
+		i = next;
+	}
+	for (struct allocpage *i = a->pool; i; ) {
 		struct allocpage *next = i->next;
 		free(i);
 		i = next;
 	}
+	if (a->region)
+		munmap(a->region, a->region_size);
 }
 
 void *allocator_new()
@@ -40,12 +115,68 @@ void *allocator_new()
 	return self;
 }
 
+void *allocator_new_mapped(long size)
+{
+	Allocator *self = malloc(sizeof(Allocator));
+	allocator_init(self);
+	void *region = mmap(NULL, size, PROT_READ | PROT_WRITE,
+			    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+			    -1, 0);
+	if (region != MAP_FAILED) {
+		page_put(self, self->pages);
+		self->region = region;
+		self->region_size = size;
+		self->pages = page_get(self, ALLOCSIZE);
+		self->pages->next = NULL;
+	}
+	return self;
+}
+
 void allocator_delete(Allocator *a)
 {
 	allocator_free(a);
 	free(a);
 }
 
+void allocator_reset(Allocator *a)
+{
+	for (struct allocpage *i = a->pages; i; ) {
+		struct allocpage *next = i->next;
+		page_put(a, i);
+		i = next;
+	}
+	a->region_cur = 0;
+	a->pages = page_get(a, ALLOCSIZE);
+	a->pages->next = NULL;
+	a->cur = 0;
+	a->used = ALLOCSIZE;
+}
+
+long allocator_used(Allocator *a)
+{
+	return a->used;
+}
+
+long allocator_peak(Allocator *a)
+{
+	return a->peak;
+}
+
+void allocator_reset_peak(Allocator *a)
+{
+	a->peak = a->used;
+}
+
+void allocator_set_limit(Allocator *a, long bytes)
+{
+	a->limit = bytes;
+}
+
+bool allocator_over_limit(Allocator *a)
+{
+	return a->limit && a->used > a->limit;
+}
+
 static int max(int a, int b)
 {
 	return a > b ? a : b;
@@ -54,16 +185,18 @@ static int max(int a, int b)
 void *allocator_memalloc(Allocator *a, int size)
 {
 	size = (size + 15) / 16 * 16;
-	if (a->cur + size < ALLOCSIZE) {
+	if (a->cur + size < a->pages->size) {
 		void *ret = &(a->pages->content[a->cur]);
 		a->cur += size;
 		return ret;
 	} else {
-		struct allocpage *n = malloc(sizeof(struct allocpage) +
-					     max(size, ALLOCSIZE));
+		struct allocpage *n = page_get(a, max(size, ALLOCSIZE));
 		n->next = a->pages;
 		a->pages = n;
 		a->cur = size;
+		a->used += n->size;
+		if (a->used > a->peak)
+			a->peak = a->used;
 		return &(a->pages->content[0]);
 	}
 }
@@ -3,14 +3,21 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "vec.h"
 #include "map.h"
+#include "allocator.h"
+#include "srcloc.h"
 
 typedef struct {
 	char (*peek)(TextStream *);
 	void (*next)(TextStream *);
 	void (*prev)(TextStream *);
 	void (*del)(TextStream *);
+	const char *(*buffer)(TextStream *, long **, long *);
 } TextStreamOps;
 
 struct TextStream_ {
@@ -37,45 +44,16 @@ void text_stream_prev(TextStream *ts)
 	ts->ops->prev(ts);
 }
 
-typedef struct {
-	TextStream h;
-	FILE *fp;
-	int c0;
-	int c;
-} FileTextStream;
-
-static void file_text_stream_delete(TextStream *ts)
-{
-	FileTextStream *ios = (FileTextStream *) ts;
-	fclose(ios->fp);
-	free(ts);
-}
-
-static char file_text_stream_peek(TextStream *ts)
-{
-	FileTextStream *ios = (FileTextStream *) ts;
-	if (ios->c == EOF)
-		return 0;
-	return ios->c;
-}
-
-static void file_text_stream_next(TextStream *ts)
+static const char *text_stream_buffer(TextStream *ts, long **pos, long *len)
 {
-	FileTextStream *ios = (FileTextStream *) ts;
-	ios->c0 = ios->c;
-	ios->c = fgetc(ios->fp);
+	return ts->ops->buffer(ts, pos, len);
 }
 
-static void file_text_stream_prev(TextStream *ts)
-{
-	FileTextStream *ios = (FileTextStream *) ts;
-	ungetc(ios->c, ios->fp);
-	ios->c = ios->c0;
-}
-
-static const TextStreamOps file_text_stream_ops = {
-	file_text_stream_peek, file_text_stream_next,
-	file_text_stream_prev, file_text_stream_delete,
+enum {
+	MEM_OWNED,
+	MEM_ARENA,
+	MEM_MAPPED,
+	MEM_BORROWED,
 };
 
 typedef struct {
@@ -83,12 +61,16 @@ typedef struct {
 	char *buf;
 	long len;
 	long i;
+	int kind;
 } MemTextStream;
 
 static void mem_text_stream_delete(TextStream *ts)
 {
 	MemTextStream *ms = (MemTextStream *) ts;
-	free(ms->buf);
+	switch (ms->kind) {
+	case MEM_OWNED: free(ms->buf); break;
+	case MEM_MAPPED: munmap(ms->buf, ms->len); break;
+	}
 	free(ts);
 }
 
@@ -114,43 +96,107 @@ static void mem_text_stream_prev(TextStream *ts)
 	ms->i--;
 }
 
+static const char *mem_text_stream_buffer(TextStream *ts, long **pos, long *len)
+{
+	MemTextStream *ms = (MemTextStream *) ts;
+	*pos = &ms->i;
+	*len = ms->len;
+	return ms->buf;
+}
+
 static const TextStreamOps mem_text_stream_ops = {
 	mem_text_stream_peek, mem_text_stream_next,
 	mem_text_stream_prev, mem_text_stream_delete,
+	mem_text_stream_buffer,
 };
 
+static MemTextStream *mem_text_stream_new(char *buf, long len, int kind)
+{
+	MemTextStream *ms = malloc(sizeof(MemTextStream));
+	ms->buf = buf;
+	ms->len = len;
+	ms->i = 0;
+	ms->kind = kind;
+	ms->h.ops = &mem_text_stream_ops;
+	return ms;
+}
+
 TextStream *text_stream_new(const char *file)
 {
-	FileTextStream *ios = malloc(sizeof(FileTextStream));
-	if (strcmp(file, "-") == 0)
-		ios->fp = stdin;
-	else
-		ios->fp = fopen(file, "r");
-	if (ios->fp)
-		ios->c = fgetc(ios->fp);
-	else
-		ios->c = EOF;
-	ios->h.ops = &file_text_stream_ops;
-	return &ios->h;
+	int fd = 0;
+	if (strcmp(file, "-") != 0)
+		fd = open(file, O_RDONLY);
+
+	struct stat st;
+	if (fd >= 0 && fstat(fd, &st) == 0 &&
+	    S_ISREG(st.st_mode) && st.st_size > 0) {
+		void *buf = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+				 fd, 0);
+		if (buf != MAP_FAILED) {
+			if (fd)
+				close(fd);
+			return &mem_text_stream_new(buf, st.st_size,
+						    MEM_MAPPED)->h;
+		}
+	}
+
+	long len = 0, cap = 65536;
+	char *buf = malloc(cap);
+	if (fd >= 0) {
+		ssize_t n;
+		while ((n = read(fd, buf + len, cap - len)) > 0) {
+			len += n;
+			if (len == cap)
+				buf = realloc(buf, cap *= 2);
+		}
+		if (fd)
+			close(fd);
+	}
+	return &mem_text_stream_new(buf, len, MEM_OWNED)->h;
 }
 
-TextStream *text_stream_from_string(const char *string)
+TextStream *text_stream_from_string(const char *string, Allocator *a)
 {
-	MemTextStream *ms = malloc(sizeof(MemTextStream));
-	ms->buf = strdup(string);
-	ms->len = strlen(string);
-	ms->i = 0;
-	ms->h.ops = &mem_text_stream_ops;
-	return &ms->h;
+	if (a)
+		return &mem_text_stream_new(allocator_strdup(a, string),
+					    strlen(string), MEM_ARENA)->h;
+	return &mem_text_stream_new(strdup(string), strlen(string),
+				    MEM_OWNED)->h;
+}
+
+TextStream *text_stream_from_buffer(const char *buf, long len)
+{
+	return &mem_text_stream_new((char *) buf, len, MEM_BORROWED)->h;
 }
 
+typedef struct {
+	int type;
+	const char *name;
+	int builtin;
+} IdentEntry;
+
+typedef map_t(IdentEntry) map_ident_t;
+
+// a file named by the line markers
+typedef struct {
+	const char *includer;	// where it was first entered from, or NULL
+	int flags;		// LINE_SYSTEM and LINE_EXTERN_C, as last seen
+} LineFile;
+
+typedef map_t(LineFile) map_linefile_t;
+
 struct Lexer_ {
 	TextStream *ts;
+	Allocator *allocator;
 	bool hol;
-	map_int_t kws;
+	map_ident_t idents;
 
 	int tok_type;
 	vec_char_t tok;
+	const char *ident;
+	int builtin;
+	const char *str_ref;
+	int str_ref_len;
 	union {
 		unsigned long long uint_cst;
 		char char_cst;
@@ -159,14 +205,61 @@ struct Lexer_ {
 
 	int line;
 	char path[256];
+	// LINE_SYSTEM and LINE_EXTERN_C of the path
+	int flags;
+	map_linefile_t files;
 	vec_char_t tok_temp;
 
 	char file[256];
+
+	// input buffer and position, where the current token starts
+	// and where the one before it ended
+	const char *buf;
+	long len, *pos;
+	long tok_off, prev_end;
+	int tok_line;
+	// tokens lexed, again after rewinding
+	long ntokens;
 };
 
-#define P text_stream_peek(l->ts)
-#define N text_stream_next(l->ts)
-#define U text_stream_prev(l->ts)
+static void tok_reserve(Lexer *l, vec_char_t *v, int n)
+{
+	if (n <= v->capacity)
+		return;
+	int cap = v->capacity ? v->capacity : 64;
+	while (cap < n)
+		cap <<= 1;
+	if (l->allocator) {
+		char *data = allocator_memalloc(l->allocator, cap);
+		if (v->length)
+			memcpy(data, v->data, v->length);
+		v->data = data;
+	} else {
+		v->data = realloc(v->data, cap);
+	}
+	v->capacity = cap;
+}
+
+#define tok_push(l, v, c)\
+	( tok_reserve(l, v, (v)->length + 1),\
+	  (v)->data[(v)->length++] = (c) )
+
+static void tok_extend(Lexer *l, vec_char_t *v, vec_char_t *v2)
+{
+	tok_reserve(l, v, v->length + v2->length);
+	memcpy(v->data + v->length, v2->data, v2->length);
+	v->length += v2->length;
+}
+
+// the input is always in memory, so skip the stream ops
+static inline char peekc(Lexer *l)
+{
+	return *l->pos < l->len ? l->buf[*l->pos] : 0;
+}
+
+#define P peekc(l)
+#define N ((*l->pos)++)
+#define U ((*l->pos)--)
 static int lex_punct(Lexer *l)
 {
 	char c = P;
@@ -384,11 +477,11 @@ static bool lex_stringbody(Lexer *l, vec_char_t *dst)
 		case '\\':
 			d = lex_escape(l);
 			if (d != 256)
-				vec_push(dst, d);
+				tok_push(l, dst, d);
 			else
 				return false;
 			break;
-		default: N; vec_push(dst, c);; break;
+		default: N; tok_push(l, dst, c);; break;
 		}
 	}
 	return false;
@@ -481,18 +574,18 @@ static bool lex_raw_stringbody(Lexer *l, vec_char_t *dst)
 					m++;
 				} else {
 					for (int i = 0; i < m; i++)
-						vec_push(dst, delim[i]);
+						tok_push(l, dst, delim[i]);
 					if (c == delim[0]) {
 						m = 1;
 					} else {
-						vec_push(dst, c);
+						tok_push(l, dst, c);
 						m = 0;
 					}
 				}
 				if (m == n) {
 					c = P;
 					if (c == '"') {
-						N; vec_push(dst, 0);
+						N; tok_push(l, dst, 0);
 						return true;
 					}
 				}
@@ -507,9 +600,9 @@ static bool lex_raw_stringbody(Lexer *l, vec_char_t *dst)
 #define LEX(name, cond) \
 static char lex_##name(Lexer *l) \
 { \
-	char c = text_stream_peek(l->ts); \
+	char c = peekc(l); \
 	if (cond) { \
-		text_stream_next(l->ts); \
+		(*l->pos)++; \
 		return c; \
 	} else { \
 		return 0; \
@@ -561,8 +654,8 @@ static bool lex_##name(Lexer *l, lex_func_t lex) \
 		return false; \
 	} \
 }
-LEX1(one, vec_push(&l->tok, c))
-LEX1(one_temp, vec_push(&l->tok_temp, c))
+LEX1(one, tok_push(l, &l->tok, c))
+LEX1(one_temp, tok_push(l, &l->tok_temp, c))
 LEX1(one_ignore,)
 
 #define LEXM(name, one) \
@@ -591,6 +684,38 @@ static bool lex_many_dsep(Lexer *l, lex_func_t lex)
 	return true;
 }
 
+// the flags after the path of a line marker, as LINE_* bits
+static int marker_flags(Lexer *l)
+{
+	const char *b = l->buf;
+	int flags = 0;
+	for (long i = *l->pos; i < l->len && b[i] != '\n'; i++)
+		if (b[i] >= '1' && b[i] <= '4' && b[i - 1] == ' ' &&
+		    (i + 1 == l->len || b[i + 1] == ' ' || b[i + 1] == '\n'))
+			flags |= 1 << (b[i] - '0');
+	return flags;
+}
+
+/* the line marker moves to path.  Each file keeps the one it was first
+   entered from; files are first seen in order, so these never loop. */
+static void line_marker(Lexer *l, const char *path)
+{
+	int flags = marker_flags(l);
+	if (flags & (LINE_ENTER | LINE_LEAVE) || strcmp(path, l->path)) {
+		LineFile *f = map_get(&l->files, path);
+		if (!f) {
+			LineFile n = { NULL, 0 };
+			if (flags & LINE_ENTER && l->path[0])
+				n.includer = allocator_strdup(l->allocator, l->path);
+			map_set(&l->files, path, n);
+			f = map_get(&l->files, path);
+		}
+		f->flags = flags & (LINE_SYSTEM | LINE_EXTERN_C);
+		strncpy(l->path, path, 255);
+	}
+	l->flags = flags & (LINE_SYSTEM | LINE_EXTERN_C);
+}
+
 static int skip_spaces(Lexer *l)
 {
 	while (true) {
@@ -602,25 +727,25 @@ static int skip_spaces(Lexer *l)
 				lex_many_ignore(l, lex_space);
 				vec_clear(&l->tok_temp);
 				if (lex_many_temp(l, lex_digit)) {
-					vec_push(&l->tok_temp, 0);
+					tok_push(l, &l->tok_temp, 0);
 					l->line = atoi(l->tok_temp.data) - 1;
 					lex_many_ignore(l, lex_space);
 					if (lex_one_ignore(l, lex_quote)) {
 						vec_clear(&(l->tok_temp));
 						if (lex_stringbody(l, &l->tok_temp)) {
-							vec_push(&l->tok_temp, 0);
-							strncpy(l->path, l->tok_temp.data, 255);
+							tok_push(l, &l->tok_temp, 0);
+							line_marker(l, l->tok_temp.data);
 							if (l->file[0] == 0)
 								strcpy(l->file, l->path);
 						}
 					}
 				} else if (lex_many_temp(l, lex_alpha)) {
-					vec_push(&l->tok_temp, 0);
+					tok_push(l, &l->tok_temp, 0);
 					if (strcmp(l->tok_temp.data, "pragma") == 0) {
 						lex_many_ignore(l, lex_space);
 						vec_clear(&l->tok_temp);
 						lex_many_temp(l, lex_not_newline);
-						vec_push(&l->tok_temp, 0);
+						tok_push(l, &l->tok_temp, 0);
 						return TOK_PP_PRAGMA_LINE;
 					}
 				}
@@ -647,9 +772,47 @@ static int skip_spaces(Lexer *l)
 #define CTREE_ULONG_MAX  18446744073709551615ull
 #define CTREE_LLONG_MAX   9223372036854775807ull
 #define CTREE_ULLONG_MAX 18446744073709551615ull
+static unsigned long long parse_dec(const char *s, int n)
+{
+	unsigned long long v = 0;
+	int i = 0;
+	for (; i < n && i < 19; i++)
+		v = v * 10 + (s[i] - '0');
+	for (; i < n; i++) {
+		unsigned int d = s[i] - '0';
+		if (v > (CTREE_ULLONG_MAX - d) / 10)
+			return CTREE_ULLONG_MAX;
+		v = v * 10 + d;
+	}
+	return v;
+}
+
+static unsigned long long parse_pow2(const char *s, int n, int bits)
+{
+	unsigned long long v = 0;
+	for (int i = 0; i < n; i++) {
+		char c = s[i];
+		unsigned int d = c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+		if (d >> bits)
+			break;
+		if (v >> (64 - bits))
+			return CTREE_ULLONG_MAX;
+		v = (v << bits) | d;
+	}
+	return v;
+}
+
 static void handle_int_cst(Lexer *l, int off, int base)
 {
-	unsigned long long v = strtoull(l->tok.data + off, NULL, base);
+	const char *digits = l->tok.data + off;
+	int n = l->tok.length - 1 - off;
+	unsigned long long v;
+	switch (base) {
+	case 16: v = parse_pow2(digits, n, 4); break;
+	case 8: v = parse_pow2(digits, n, 3); break;
+	case 2: v = parse_pow2(digits, n, 1); break;
+	default: v = parse_dec(digits, n); break;
+	}
 	bool is_unsigned = false;
 	bool is_long = false;
 	bool is_longlong = false;
@@ -708,11 +871,161 @@ static void handle_int_cst(Lexer *l, int off, int base)
 	l->u.uint_cst = v;
 }
 
+typedef struct {
+	int mbits;
+	int min_exp;
+	int inf_power;
+	int min_round_even;
+	int max_round_even;
+	int min_p10;
+	int max_p10;
+	int max_exact_p10;
+} FloatFormat;
+
+static const FloatFormat binary64 = { 52, -1023, 0x7ff, -4, 23, -342, 308, 22 };
+static const FloatFormat binary32 = { 23, -127, 0xff, -17, 10, -64, 38, 10 };
+
+#define POW5_MIN (-342)
+static const unsigned long long pow5_table[][2] = {
+#include "lexer-pow5.inc"
+};
+
+static const double exact_p10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// Eisel-Lemire: w * 10^q rounded to nearest-even, as IEEE bits of format f
+static unsigned long long eisel_lemire(const FloatFormat *f,
+				       unsigned long long w, int q)
+{
+	if (w == 0 || q < f->min_p10)
+		return 0;
+	if (q > f->max_p10)
+		return (unsigned long long) f->inf_power << f->mbits;
+	int lz = __builtin_clzll(w);
+	w <<= lz;
+	const unsigned long long *t = pow5_table[q - POW5_MIN];
+	unsigned __int128 product = (unsigned __int128) w * t[0];
+	unsigned long long mask = ~0ull >> (f->mbits + 3);
+	if (((unsigned long long) (product >> 64) & mask) == mask)
+		product += ((unsigned __int128) w * t[1]) >> 64;
+	unsigned long long hi = product >> 64;
+	unsigned long long lo = product;
+
+	int upperbit = hi >> 63;
+	int shift = upperbit + 64 - f->mbits - 3;
+	unsigned long long m = hi >> shift;
+	int power2 = (((152170 + 65536) * q) >> 16) + 63 + upperbit - lz - f->min_exp;
+	if (power2 <= 0) {
+		if (-power2 + 1 >= 64)
+			return 0;
+		m >>= -power2 + 1;
+		m += m & 1;
+		m >>= 1;
+		power2 = m < (1ull << f->mbits) ? 0 : 1;
+		return ((unsigned long long) power2 << f->mbits) |
+			(m & ((1ull << f->mbits) - 1));
+	}
+	if (lo <= 1 && q >= f->min_round_even && q <= f->max_round_even &&
+	    (m & 3) == 1) {
+		if ((m << shift) == hi)
+			m &= ~1ull;
+	}
+	m += m & 1;
+	m >>= 1;
+	if (m >= (2ull << f->mbits)) {
+		m = 1ull << f->mbits;
+		power2++;
+	}
+	m &= ~(1ull << f->mbits);
+	if (power2 >= f->inf_power)
+		return (unsigned long long) f->inf_power << f->mbits;
+	return ((unsigned long long) power2 << f->mbits) | m;
+}
+
+// decimal literal in l->tok to IEEE bits; false if strto[fd] must decide
+static bool parse_float_fast(Lexer *l, const FloatFormat *f,
+			     unsigned long long *bits)
+{
+	const char *s = l->tok.data;
+	unsigned long long w = 0;
+	int nd = 0;
+	long q = 0;
+	bool trunc = false;
+	for (; *s >= '0' && *s <= '9'; s++) {
+		if (nd < 19) {
+			w = w * 10 + (*s - '0');
+			nd += w != 0;
+		} else {
+			trunc |= *s != '0';
+			q++;
+		}
+	}
+	if (*s == '.') {
+		for (s++; *s >= '0' && *s <= '9'; s++) {
+			if (nd < 19) {
+				w = w * 10 + (*s - '0');
+				nd += w != 0;
+				q--;
+			} else {
+				trunc |= *s != '0';
+			}
+		}
+	}
+	if (*s == 'e' || *s == 'E') {
+		bool neg = false;
+		long e = 0;
+		s++;
+		if (*s == '+' || *s == '-')
+			neg = *s++ == '-';
+		for (; *s >= '0' && *s <= '9'; s++) {
+			if (e < 100000)
+				e = e * 10 + (*s - '0');
+		}
+		q += neg ? -e : e;
+	}
+	if (*s != 0)
+		return false;
+
+	if (!trunc && q >= -f->max_exact_p10 && q <= f->max_exact_p10 &&
+	    w <= (1ull << (f->mbits + 1))) {
+		if (f == &binary32) {
+			float v = w;
+			float p = exact_p10[q < 0 ? -q : q];
+			v = q < 0 ? v / p : v * p;
+			unsigned int b;
+			memcpy(&b, &v, sizeof(b));
+			*bits = b;
+		} else {
+			double v = w;
+			double p = exact_p10[q < 0 ? -q : q];
+			v = q < 0 ? v / p : v * p;
+			memcpy(bits, &v, sizeof(*bits));
+		}
+		return true;
+	}
+	if (q < -100000 || q > 100000)
+		q = q < 0 ? -100000 : 100000;
+	*bits = eisel_lemire(f, w, q);
+	return !trunc || eisel_lemire(f, w + 1, q) == *bits;
+}
+
 static void handle_float_cst(Lexer *l)
 {
-	char *endp;
+	char *endp = "";
+	unsigned long long bits;
+	bool hex = l->tok.data[0] == '0' &&
+		(l->tok.data[1] == 'x' || l->tok.data[1] == 'X');
 	if (lex_one_ignore(l, lex_fF)) {
-		l->u.float_cst = strtof(l->tok.data, &endp);
+		if (!hex && parse_float_fast(l, &binary32, &bits)) {
+			unsigned int b = bits;
+			float v;
+			memcpy(&v, &b, sizeof(v));
+			l->u.float_cst = v;
+		} else {
+			l->u.float_cst = strtof(l->tok.data, &endp);
+		}
 		if (*endp != '\0') {
 			l->tok_type = TOK_ERROR;
 		} else {
@@ -720,7 +1033,10 @@ static void handle_float_cst(Lexer *l)
 		}
 	} else {
 		lex_one_ignore(l, lex_lL);
-		l->u.float_cst = strtod(l->tok.data, &endp);
+		if (!hex && parse_float_fast(l, &binary64, &bits))
+			memcpy(&l->u.float_cst, &bits, sizeof(bits));
+		else
+			l->u.float_cst = strtod(l->tok.data, &endp);
 		if (*endp != '\0') {
 			l->tok_type = TOK_ERROR;
 		} else {
@@ -740,13 +1056,13 @@ static bool lex_float(Lexer *l)
 				if (lex_many(l, lex_digit)) {
 					if (!lex_many_dsep(l, lex_digit))
 						return true;
-					vec_push(&l->tok, 0);
+					tok_push(l, &l->tok, 0);
 				} else {
 					l->tok_type = TOK_ERROR;
 					return true;
 				}
 			} else {
-				vec_push(&l->tok, 0);
+				tok_push(l, &l->tok, 0);
 			}
 		} else {
 			if (l->tok.length == 1) {
@@ -759,13 +1075,13 @@ static bool lex_float(Lexer *l)
 					if (lex_many(l, lex_digit)) {
 						if (!lex_many_dsep(l, lex_digit))
 							return true;
-						vec_push(&l->tok, 0);
+						tok_push(l, &l->tok, 0);
 					} else {
 						l->tok_type = TOK_ERROR;
 						return true;
 					}
 				} else {
-					vec_push(&l->tok, 0);
+					tok_push(l, &l->tok, 0);
 				}
 			}
 		}
@@ -778,7 +1094,7 @@ static bool lex_float(Lexer *l)
 				if (lex_many(l, lex_digit)) {
 					if (!lex_many_dsep(l, lex_digit))
 						return true;
-					vec_push(&l->tok, 0);
+					tok_push(l, &l->tok, 0);
 				} else {
 					l->tok_type = TOK_ERROR;
 					return true;
@@ -804,7 +1120,7 @@ static bool lex_0xfloat(Lexer *l)
 			if (lex_many(l, lex_digit)) {
 				if (!lex_many_dsep(l, lex_digit))
 					return true;
-				vec_push(&l->tok, 0);
+				tok_push(l, &l->tok, 0);
 				handle_float_cst(l);
 				return true;
 			}
@@ -816,7 +1132,7 @@ static bool lex_0xfloat(Lexer *l)
 		if (lex_many(l, lex_digit)) {
 			if (!lex_many_dsep(l, lex_digit))
 				return true;
-			vec_push(&l->tok, 0);
+			tok_push(l, &l->tok, 0);
 			handle_float_cst(l);
 			return true;
 		}
@@ -826,22 +1142,59 @@ static bool lex_0xfloat(Lexer *l)
 	return false;
 }
 
+static bool lex_string_ref(Lexer *l)
+{
+	long *pos, len;
+	const char *buf = text_stream_buffer(l->ts, &pos, &len);
+	for (long i = *pos; i < len; i++) {
+		char c = buf[i];
+		if (c == '"') {
+			l->str_ref = buf + *pos;
+			l->str_ref_len = i - *pos;
+			*pos = i + 1;
+			return true;
+		}
+		if (c == '\\' || c == 0)
+			return false;
+	}
+	return false;
+}
+
+static void materialize_string(Lexer *l)
+{
+	tok_reserve(l, &l->tok, l->tok.length + l->str_ref_len);
+	memcpy(l->tok.data + l->tok.length, l->str_ref, l->str_ref_len);
+	l->tok.length += l->str_ref_len;
+	l->str_ref = NULL;
+}
+
 static bool lex_string_or_char(Lexer *l, int stype, int ctype)
 {
 	if (stype && lex_one_ignore(l, lex_quote)) {
 		vec_clear(&l->tok);
-		do {
-			if (!lex_stringbody(l, &l->tok) ||
-			    !lex_one_ignore(l, lex_quote)) {
+		if (!lex_string_ref(l) &&
+		    (!lex_stringbody(l, &l->tok) ||
+		     !lex_one_ignore(l, lex_quote))) {
+			l->tok_type = TOK_ERROR;
+			return true;
+		}
+		while (true) {
+			if (skip_spaces(l) != 0) {
 				l->tok_type = TOK_ERROR;
 				return true;
 			}
-			if (skip_spaces(l) != 0) {
+			if (!lex_one_ignore(l, lex_quote))
+				break;
+			if (l->str_ref)
+				materialize_string(l);
+			if (!lex_stringbody(l, &l->tok) ||
+			    !lex_one_ignore(l, lex_quote)) {
 				l->tok_type = TOK_ERROR;
 				return true;
 			}
-		} while (lex_one_ignore(l, lex_quote));
-		vec_push(&l->tok, 0);
+		}
+		if (!l->str_ref)
+			tok_push(l, &l->tok, 0);
 		l->tok_type = stype;
 		return true;
 	}
@@ -858,7 +1211,7 @@ static bool lex_string_or_char(Lexer *l, int stype, int ctype)
 
 static bool lex_string_or_char_prefix(Lexer *l, const char *prefix)
 {
-	char c = text_stream_peek(l->ts);
+	char c = peekc(l);
 	if (c == '"' || c == '\'') {
 		int ctype = 0;
 		int stype = 0;
@@ -916,26 +1269,49 @@ static bool lex_string_or_char_prefix(Lexer *l, const char *prefix)
 	return false;
 }
 
+static IdentEntry *lookup_ident(Lexer *l)
+{
+	IdentEntry *e = map_get(&l->idents, l->tok.data);
+	if (!e && l->allocator) {
+		IdentEntry n = {
+			.type = TOK_IDENT,
+			.name = allocator_strdup(l->allocator, l->tok.data),
+		};
+		map_set(&l->idents, n.name, n);
+		e = map_get(&l->idents, n.name);
+	}
+	return e;
+}
+
 void lexer_next(Lexer *l)
 {
 	int tt;
 	vec_clear(&l->tok);
+	l->ntokens++;
+	l->ident = NULL;
+	l->builtin = BUILTIN_NONE;
+	l->str_ref = NULL;
+	l->prev_end = *l->pos;
 	tt = skip_spaces(l);
+	l->tok_off = *l->pos;
+	l->tok_line = l->line;
 	if (tt) {
 		l->tok_type = tt;
 		vec_clear(&l->tok);
-		vec_extend(&l->tok, &l->tok_temp);
+		tok_extend(l, &l->tok, &l->tok_temp);
 		return;
 	}
 	if (lex_one(l, lex_alpha_)) {
 		lex_many(l, lex_alphadigit_);
-		vec_push(&l->tok, 0);
+		tok_push(l, &l->tok, 0);
 		if (lex_string_or_char_prefix(l, l->tok.data)) {
 			return;
 		}
-		int *type = map_get(&l->kws, l->tok.data);
-		if (type) {
-			l->tok_type = *type;
+		IdentEntry *e = lookup_ident(l);
+		if (e) {
+			l->tok_type = e->type;
+			l->ident = e->name;
+			l->builtin = e->builtin;
 		} else {
 			l->tok_type = TOK_IDENT;
 		}
@@ -945,7 +1321,7 @@ void lexer_next(Lexer *l)
 				if (!lex_many_dsep(l, lex_hex))
 					return;
 				if (!lex_0xfloat(l)) {
-					vec_push(&l->tok, 0);
+					tok_push(l, &l->tok, 0);
 					handle_int_cst(l, 2, 16);
 				}
 			} else {
@@ -955,7 +1331,7 @@ void lexer_next(Lexer *l)
 			if (lex_many(l, lex_bin)) {
 				if (!lex_many_dsep(l, lex_bin))
 					return;
-				vec_push(&l->tok, 0);
+				tok_push(l, &l->tok, 0);
 				handle_int_cst(l, 2, 2);
 			} else {
 				l->tok_type = TOK_ERROR;
@@ -966,7 +1342,7 @@ void lexer_next(Lexer *l)
 				if (!lex_many_dsep(l, lex_digit))
 					return;
 				if (!lex_float(l)) {
-					vec_push(&l->tok, 0);
+					tok_push(l, &l->tok, 0);
 					handle_int_cst(l, 1, 8);
 				}
 			} else {
@@ -975,7 +1351,7 @@ void lexer_next(Lexer *l)
 					return;
 				}
 				if (!lex_float(l)) {
-					vec_push(&l->tok, 0);
+					tok_push(l, &l->tok, 0);
 					handle_int_cst(l, 0, 10); // zero
 				}
 			}
@@ -984,10 +1360,10 @@ void lexer_next(Lexer *l)
 		if (!lex_many_dsep(l, lex_digit))
 			return;
 		if (!lex_float(l)) {
-			vec_push(&l->tok, 0);
+			tok_push(l, &l->tok, 0);
 			handle_int_cst(l, 0, 10);
 		}
-	} else if (text_stream_peek(l->ts) == 0) {
+	} else if (peekc(l) == 0) {
 		l->tok_type = TOK_END;
 	} else {
 		if (lex_float(l)) {
@@ -1001,10 +1377,59 @@ void lexer_next(Lexer *l)
 		if (lex_string_or_char(l, TOK_STRING_CST, TOK_CHAR_CST)) {
 			return;
 		}
+		// a stray character, which error recovery may pass over
+		(*l->pos)++;
 		l->tok_type = TOK_ERROR;
 	}
 }
 
+LexerMark lexer_mark(Lexer *l)
+{
+	LexerMark m = { l->tok_off, l->tok_line };
+	return m;
+}
+
+void lexer_rewind(Lexer *l, LexerMark m)
+{
+	// line markers on the way are read again, and set the path
+	*l->pos = m.off;
+	l->line = m.line;
+	l->hol = false;
+	lexer_next(l);
+}
+
+void lexer_rewind_path(Lexer *l, LexerMark m, const char *path, int flags)
+{
+	if (path != l->path)
+		strncpy(l->path, path, 255);
+	l->flags = flags;
+	lexer_rewind(l, m);
+}
+
+const char *lexer_text_since(Lexer *l, LexerMark m, long *len)
+{
+	long end = l->prev_end;
+	*len = end > m.off ? end - m.off : 0;
+	return l->buf + m.off;
+}
+
+void lexer_skip_to_end(Lexer *l)
+{
+	*l->pos = l->len;
+	lexer_next(l);
+}
+
+long lexer_token_count(Lexer *l)
+{
+	return l->ntokens;
+}
+
+const char *lexer_input(Lexer *l, long *len)
+{
+	*len = l->len;
+	return l->buf;
+}
+
 int lexer_peek(Lexer *l)
 {
 	return l->tok_type;
@@ -1012,14 +1437,35 @@ int lexer_peek(Lexer *l)
 
 const char *lexer_peek_string(Lexer *l)
 {
+	if (l->str_ref) {
+		materialize_string(l);
+		tok_push(l, &l->tok, 0);
+	}
 	return l->tok.data;
 }
 
 int lexer_peek_string_len(Lexer *l)
 {
+	if (l->str_ref)
+		return l->str_ref_len + 1;
 	return l->tok.length;
 }
 
+const char *lexer_peek_string_ref(Lexer *l)
+{
+	return l->str_ref;
+}
+
+const char *lexer_peek_ident(Lexer *l)
+{
+	return l->ident;
+}
+
+int lexer_peek_builtin(Lexer *l)
+{
+	return l->builtin;
+}
+
 unsigned long long lexer_peek_uint(Lexer *l)
 {
 	return l->u.uint_cst;
@@ -1035,38 +1481,54 @@ double lexer_peek_float(Lexer *l)
 	return l->u.float_cst;
 }
 
-static void lexer_init(Lexer *l, TextStream *ts)
+static void lexer_init(Lexer *l, TextStream *ts, Allocator *a)
 {
 	l->ts = ts;
+	l->allocator = a;
 	l->hol = true;
 	vec_init(&l->tok);
 
-	map_init(&l->kws);
-#define KWS(str, type) map_set(&l->kws, str, type)
+	map_init_alloc(&l->idents, a);
+#define KWS(str, t) \
+	map_set(&l->idents, str, ((IdentEntry) { .type = t, .name = str }))
 #include "keywords.def"
 #undef KWS
-
-	l->line = 1;
+#define BUILTIN(str, b) \
+	map_set(&l->idents, str, \
+		((IdentEntry) { .type = TOK_IDENT, .name = str, .builtin = b }))
+#include "builtins.def"
+#undef BUILTIN
+
+	// the first line counts as it starts, like any other
+	l->line = 0;
 	l->path[255] = 0;
 	strncpy(l->path, "", 255);
 	vec_init(&l->tok_temp);
 
 	l->file[0] = 0;
 
+	l->buf = text_stream_buffer(ts, &l->pos, &l->len);
+	l->flags = 0;
+	map_init_alloc(&l->files, a);
+	l->ntokens = 0;
+
 	lexer_next(l);
 }
 
 static void lexer_free(Lexer *l)
 {
-	vec_deinit(&l->tok);
-	map_deinit(&l->kws);
-	vec_deinit(&l->tok_temp);
+	map_deinit(&l->idents);
+	map_deinit(&l->files);
+	if (!l->allocator) {
+		vec_deinit(&l->tok);
+		vec_deinit(&l->tok_temp);
+	}
 }
 
-Lexer *lexer_new(TextStream *ts)
+Lexer *lexer_new(TextStream *ts, Allocator *a)
 {
 	Lexer *self = malloc(sizeof(Lexer));
-	lexer_init(self, ts);
+	lexer_init(self, ts, a);
 	return self;
 }
 
@@ -1081,6 +1543,23 @@ const char *lexer_report_path(Lexer *l)
 	return l->path;
 }
 
+bool lexer_in_system_header(Lexer *l)
+{
+	return l->flags & LINE_SYSTEM;
+}
+
+int lexer_report_flags(Lexer *l)
+{
+	return l->flags;
+}
+
+const char *lexer_includer(Lexer *l, const char *path, int *flags)
+{
+	LineFile *f = map_get(&l->files, path);
+	*flags = f ? f->flags : 0;
+	return f ? f->includer : NULL;
+}
+
 const char *lexer_report_file(Lexer *l)
 {
 	return l->file;
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "map.h"
+#include "allocator.h"
 
 struct map_node_t {
   unsigned hash;
@@ -28,11 +29,24 @@ static unsigned map_hash(const char *str, int ksize) {
 }
 
 
-static map_node_t *map_newnode(const char *key, int ksize, void *value, int vsize) {
+static void *map_alloc(map_base_t *m, int size) {
+  if (m->allocator)
+    return allocator_memalloc(m->allocator, size);
+  return malloc(size);
+}
+
+
+static void map_free(map_base_t *m, void *p) {
+  if (!m->allocator)
+    free(p);
+}
+
+
+static map_node_t *map_newnode(map_base_t *m, const char *key, int ksize, void *value, int vsize) {
   map_node_t *node;
 //  int ksize = strlen(key) + 1;
   int voffset = ksize + ((sizeof(void*) - ksize) % sizeof(void*));
-  node = malloc(sizeof(*node) + voffset + vsize);
+  node = map_alloc(m, sizeof(*node) + voffset + vsize);
   if (!node) return NULL;
   memcpy(node + 1, key, ksize);
   node->hash = map_hash(key, ksize);
@@ -74,7 +88,10 @@ static int map_resize(map_base_t *m, int nbuckets) {
     }
   }
   /* Reset buckets */
-  buckets = realloc(m->buckets, sizeof(*m->buckets) * nbuckets);
+  if (m->allocator)
+    buckets = allocator_memalloc(m->allocator, sizeof(*m->buckets) * nbuckets);
+  else
+    buckets = realloc(m->buckets, sizeof(*m->buckets) * nbuckets);
   if (buckets != NULL) {
     m->buckets = buckets;
     m->nbuckets = nbuckets;
@@ -94,12 +111,22 @@ static int map_resize(map_base_t *m, int nbuckets) {
 }
 
 
+/* chain nodes looked at by lookups, in all maps.  Not atomic: the
+ * printing threads don't look anything up. */
+static long map_probes;
+
+long map_probe_count(void) {
+  return map_probes;
+}
+
+
 static map_node_t **map_getref(map_base_t *m, const char *key, int ksize) {
   unsigned hash = map_hash(key, ksize);
   map_node_t **next;
   if (m->nbuckets > 0) {
     next = &m->buckets[map_bucketidx(m, hash)];
     while (*next) {
+      map_probes++;
       if ((*next)->hash == hash &&
           (*next)->ksize == ksize &&
           !memcmp((char*) (*next + 1), key, ksize)) {
@@ -120,11 +147,11 @@ void map_deinit_(map_base_t *m) {
     node = m->buckets[i];
     while (node) {
       next = node->next;
-      free(node);
+      map_free(m, node);
       node = next;
     }
   }
-  free(m->buckets);
+  map_free(m, m->buckets);
 }
 
 
@@ -144,7 +171,7 @@ int map_set_(map_base_t *m, const char *key, int ksize, void *value, int vsize)
     return 0;
   }
   /* Add new node */
-  node = map_newnode(key, ksize, value, vsize);
+  node = map_newnode(m, key, ksize, value, vsize);
   if (node == NULL) goto fail;
   if (m->nnodes >= m->nbuckets) {
     n = (m->nbuckets > 0) ? (m->nbuckets << 1) : 1;
@@ -155,7 +182,7 @@ int map_set_(map_base_t *m, const char *key, int ksize, void *value, int vsize)
   m->nnodes++;
   return 0;
   fail:
-  if (node) free(node);
+  if (node) map_free(m, node);
   return -1;
 }
 
@@ -166,7 +193,7 @@ void map_remove_(map_base_t *m, const char *key, int ksize) {
   if (next) {
     node = *next;
     *next = (*next)->next;
-    free(node);
+    map_free(m, node);
     m->nnodes--;
   }
 }
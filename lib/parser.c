@@ -5,6 +5,8 @@
 #include <assert.h>
 #include <stdio.h>
 #include "map.h"
+#include "vec.h"
+#include "srcloc.h"
 
 enum {
 	SYM_IDENT = 1,
@@ -16,13 +18,48 @@ struct scope_item {
 	map_int_t syms;
 };
 
+typedef struct {
+	Expr *a, *mid;
+	int op, prec;
+} BinOpItem;
+
+// a type name an item declares at file scope, or hides
+typedef struct {
+	const char *name;
+	int sv;
+} UnitSym;
+typedef vec_t(UnitSym) vec_unitsym_t;
+
 struct Parser_ {
 	Lexer *lexer;
+	Allocator *allocator;
 	struct scope_item *scopes;
 	int counter;
 	int next_count;
+	// budget_check() runs when next_count gets here
+	long next_check;
+	long token_limit;
+	Allocator *watch;
+	bool over;
 
 	int managed_count;
+	LocTable *locs;
+	// operators waiting for their right operand
+	vec_t(BinOpItem) binops;
+	// unary and cast expressions being parsed, one inside the other
+	int nesting;
+	// pass unparsable items through as text
+	bool recover;
+	// take items of system headers by their tokens
+	bool skim;
+	// leave function bodies unparsed until asked for
+	bool lazy;
+	vec_t(ParseError) errors;
+	// values read by parse_packed_initializer()
+	vec_t(int) packed;
+	// where reparse_unit() takes note of the file scope names
+	struct scope_item *unit;
+	vec_unitsym_t *journal;
 };
 
 static int symlookup(Parser *p, const char *sym)
@@ -38,12 +75,24 @@ static int symlookup(Parser *p, const char *sym)
 	return v;
 }
 
+/* Only type names change how later items parse, so reparse_unit()
+   takes note of the ones set or hidden at file scope. */
+static void symdef(Parser *p, const char *sym, int sv)
+{
+	if (p->journal && p->scopes == p->unit) {
+		int *pv = map_get(&(p->scopes->syms), sym);
+		if (sv == SYM_TYPE || (pv && *pv == SYM_TYPE))
+			vec_push(p->journal, ((UnitSym) { sym, sv }));
+	}
+	map_set(&(p->scopes->syms), sym, sv);
+}
+
 static bool symset(Parser *p, const char *sym, int sv)
 {
 	int *pv = map_get(&(p->scopes->syms), sym);
 	if (pv && *pv != sv)
 		return false;
-	map_set(&(p->scopes->syms), sym, sv);
+	symdef(p, sym, sv);
 	return true;
 }
 
@@ -54,11 +103,21 @@ static struct scope_item *get_scope(Parser *p)
 	return i;
 }
 
-static struct scope_item *dup_scope(Parser *p)
+static struct scope_item *new_scope(Parser *p)
 {
-	struct scope_item *i = malloc(sizeof(struct scope_item));
+	struct scope_item *i;
+	if (p->allocator)
+		i = allocator_memalloc(p->allocator, sizeof(struct scope_item));
+	else
+		i = malloc(sizeof(struct scope_item));
 	i->next = NULL;
-	map_init(&(i->syms));
+	map_init_alloc(&(i->syms), p->allocator);
+	return i;
+}
+
+static struct scope_item *dup_scope(Parser *p)
+{
+	struct scope_item *i = new_scope(p);
 
 	const char *key;
 	map_iter_t iter = map_iter(&(p->scopes->syms));
@@ -70,18 +129,15 @@ static struct scope_item *dup_scope(Parser *p)
 
 static void restore_scope(Parser *p, struct scope_item *i)
 {
-	if (i == NULL) {
-		i = malloc(sizeof(struct scope_item));
-		i->next = NULL;
-		map_init(&(i->syms));
-	}
+	if (i == NULL)
+		i = new_scope(p);
 	i->next = p->scopes;
 	p->scopes = i;
 }
 
 static void free_scope(struct scope_item *i)
 {
-	if (i) {
+	if (i && !i->syms.base.allocator) {
 		map_deinit(&(i->syms));
 		free(i);
 	}
@@ -99,28 +155,52 @@ static void leave_scope(Parser *p)
 }
 
 static const char *const gcc_builtin_types[];
-static void parser_init(Parser *p, Lexer *l)
+// tokens between checks of the allocators
+#define BUDGET_STEP 4096
+static void parser_init(Parser *p, Lexer *l, Allocator *a)
 {
 	p->lexer = l;
+	p->allocator = a;
 	p->scopes = NULL;
+	p->unit = NULL;
+	p->journal = NULL;
 	enter_scope(p);
 	for (const char *const *t = gcc_builtin_types; *t; t++)
 		symset(p, *t, SYM_TYPE);
 	p->counter = 0;
 	p->next_count = 0;
+	p->next_check = BUDGET_STEP;
+	p->token_limit = 0;
+	p->watch = NULL;
+	p->over = false;
 
 	p->managed_count = 0;
+	p->locs = NULL;
+	vec_init(&p->binops);
+	p->nesting = 0;
+	p->recover = false;
+	p->skim = false;
+	p->lazy = false;
+	vec_init(&p->errors);
+	vec_init(&p->packed);
 }
 
 static void parser_free(Parser *p)
 {
+	ParseError *e;
+	int i;
+	vec_foreach_ptr(&p->errors, e, i)
+		free((char *) e->path);
+	vec_deinit(&p->errors);
+	vec_deinit(&p->packed);
+	vec_deinit(&p->binops);
 	leave_scope(p);
 }
 
-Parser *parser_new(Lexer *l)
+Parser *parser_new(Lexer *l, Allocator *a)
 {
 	Parser *self = malloc(sizeof(Parser));
-	parser_init(self, l);
+	parser_init(self, l, a);
 	return self;
 }
 
@@ -130,6 +210,121 @@ void parser_delete(Parser *p)
 	free(p);
 }
 
+void parser_set_locations(Parser *p, LocTable *t)
+{
+	p->locs = t;
+}
+
+void parser_set_recovery(Parser *p, bool b)
+{
+	p->recover = b;
+}
+
+void parser_set_skim(Parser *p, bool b)
+{
+	p->skim = b;
+}
+
+void parser_set_lazy(Parser *p, bool b)
+{
+	p->lazy = b;
+}
+
+static void budget_next(Parser *p)
+{
+	p->next_check = p->next_count + BUDGET_STEP;
+	if (p->token_limit && p->next_check > p->token_limit)
+		p->next_check = p->token_limit;
+}
+
+void parser_set_token_limit(Parser *p, long tokens)
+{
+	p->token_limit = tokens;
+	budget_next(p);
+}
+
+void parser_watch_allocator(Parser *p, Allocator *a)
+{
+	p->watch = a;
+}
+
+bool parser_over_budget(Parser *p)
+{
+	return p->over;
+}
+
+// once over, the input looks ended and parsing unwinds
+static void budget_check(Parser *p)
+{
+	if ((p->token_limit && p->next_count >= p->token_limit) ||
+	    (p->allocator && allocator_over_limit(p->allocator)) ||
+	    (p->watch && allocator_over_limit(p->watch))) {
+		p->over = true;
+		p->next_check = -1;
+		lexer_skip_to_end(p->lexer);
+		return;
+	}
+	budget_next(p);
+}
+
+const ParseError *parser_errors(Parser *p, int *count)
+{
+	*count = p->errors.length;
+	return p->errors.data;
+}
+
+void parser_begin_unit(Parser *p)
+{
+	enter_scope(p);
+}
+
+bool parser_end_of_unit(Parser *p)
+{
+	return lexer_peek(p->lexer) == TOK_END;
+}
+
+void parser_end_unit(Parser *p)
+{
+	leave_scope(p);
+}
+
+typedef struct {
+	int file;
+	int line;
+} SrcLoc;
+
+// nested includes deeper than this are taken as not included
+#define LOC_DEPTH 200
+
+static int loc_file(Parser *p, const char *path, int depth)
+{
+	int file = loctable_find(p->locs, path);
+	if (file < 0) {
+		int flags, parent = -1;
+		const char *from = lexer_includer(p->lexer, path, &flags);
+		if (from && depth < LOC_DEPTH)
+			parent = loc_file(p, from, depth + 1);
+		file = loctable_add(p->locs, path, parent, flags);
+	}
+	return file;
+}
+
+static SrcLoc loc_here(Parser *p)
+{
+	SrcLoc loc = { 0, 0 };
+	if (p->locs) {
+		loc.file = loc_file(p, lexer_report_path(p->lexer), 0);
+		loc.line = lexer_report_line(p->lexer);
+	}
+	return loc;
+}
+
+static void loc_record(Parser *p, Stmt *s, SrcLoc loc)
+{
+	if (p->locs && s)
+		loctable_set(p->locs, s, loc.file, loc.line);
+}
+
 BEGIN_MANAGED
 
 static const char *__new_cstring(const char *s)
@@ -146,7 +341,8 @@ static const char *__new_cstring(const char *s)
 #define PI lexer_peek_uint(p->lexer)
 #define PF lexer_peek_float(p->lexer)
 #define PC lexer_peek_char(p->lexer)
-#define N (lexer_next(p->lexer), p->next_count++)
+#define N (lexer_next(p->lexer), \
+	   ++p->next_count == p->next_check ? budget_check(p) : (void) 0)
 #define F_(cond, errval, ...) do { if (!(cond)) { __VA_ARGS__; return errval; } } while (0)
 #define F(cond, ...) F_(cond, 0, ## __VA_ARGS__)
 
@@ -161,25 +357,21 @@ static int match(Parser *p, int token)
 
 static const char *get_and_next(Parser *p)
 {
-	const char *id = __new_cstring(PS);
+	const char *id = lexer_peek_ident(p->lexer);
+	if (!id)
+		id = __new_cstring(PS);
 	N; return id;
 }
 
 static Expr *parse_primary_expr(Parser *p);        // 1
 static Expr *parse_postfix_expr(Parser *p);        // 2
+/* operands nested deeper than this are a syntax error, well before
+   the recursion runs out of stack */
+#define NEST_MAX 10000
+
 static Expr *parse_unary_expr(Parser *p);          // 3
 static Expr *parse_cast_expr(Parser *p);           // 4
-static Expr *parse_multiplicative_expr(Parser *p); // 5
-static Expr *parse_additive_expr(Parser *p);       // 6
-static Expr *parse_shift_expr(Parser *p);          // 7
-static Expr *parse_relational_expr(Parser *p);     // 8
-static Expr *parse_equality_expr(Parser *p);       // 9
-static Expr *parse_band_expr(Parser *p);           // 10
-static Expr *parse_bxor_expr(Parser *p);           // 11
-static Expr *parse_bor_expr(Parser *p);            // 12
-static Expr *parse_and_expr(Parser *p);            // 13
-static Expr *parse_or_expr(Parser *p);             // 14
-static Expr *parse_conditional_expr(Parser *p);    // 15
+static Expr *parse_conditional_expr(Parser *p);    // 5-15
 static Expr *parse_assignment_expr(Parser *p);     // 16
 static Expr *parse_initializer(Parser *p);
 
@@ -196,14 +388,17 @@ static Expr *parse_parentheses_post(Parser *p)
 	}
 }
 
-static Expr *parse_builtin_gnu(Parser *p, const char *id);
-static Expr *parse_ident_or_builtin(Parser *p, const char *id)
+static Expr *parse_builtin_gnu(Parser *p, int builtin);
+// builtin is the lexer's BUILTIN_* of id
+static Expr *parse_ident_or_builtin(Parser *p, const char *id, int builtin)
 {
-	Expr *e = parse_builtin_gnu(p, id);
-	if (e)
-		return e;
+	if (builtin) {
+		Expr *e = parse_builtin_gnu(p, builtin);
+		if (e)
+			return e;
+	}
 
-	if (strcmp(id, "__typename__") == 0) {
+	if (builtin == BUILTIN_TYPENAME) {
 		Type *type;
 		F(match(p, '('));
 		F(type = parse_type(p));
@@ -219,8 +414,9 @@ static Expr *parse_primary_expr(Parser *p)
 {
 	switch (P) {
 	case TOK_IDENT: {
+		int builtin = lexer_peek_builtin(p->lexer);
 		const char *id = get_and_next(p);
-		return parse_ident_or_builtin(p, id);
+		return parse_ident_or_builtin(p, id, builtin);
 	}
 	case TOK_INT_CST: {
 		int i = PI;
@@ -274,8 +470,12 @@ static Expr *parse_primary_expr(Parser *p)
 		case TOK_WSTRING_CST_u8: kind = WCK_u8; break;
 		}
 		int len = PSL;
-		char *str = __new_(len);
-		memcpy(str, PS, len);
+		const char *str = lexer_peek_string_ref(p->lexer);
+		if (!str) {
+			char *s = __new_(len);
+			memcpy(s, PS, len);
+			str = s;
+		}
 		N; return exprSTRING_CST(str, len, kind);
 	}
 	case TOK_FLOAT_CST: {
@@ -308,8 +508,7 @@ static Expr *parse_primary_expr(Parser *p)
 	}
 }
 
-static Expr *parse_assignment_expr_post(Parser *p, Expr *e, int prec);
-static Expr *parse_multiplicative_expr_post(Parser *p, Expr *e, int prec);
+static Expr *parse_expr_post(Parser *p, Expr *e, int prec);
 static Expr *parse_postfix_expr_post(Parser *p, Expr *e, int prec) // 2
 {
 	if (prec < 2)
@@ -364,11 +563,7 @@ static Expr *parse_postfix_expr_post(Parser *p, Expr *e, int prec) // 2
 			break;
 		}
 		default:
-			if (P == '=') {
-				return parse_assignment_expr_post(p, e, prec);
-			} else {
-				return parse_multiplicative_expr_post(p, e, prec);
-			}
+			return parse_expr_post(p, e, prec);
 		}
 	}
 }
@@ -380,7 +575,7 @@ static Expr *applyUOP(ExprUnOp op, Expr *e)
 	return NULL;
 }
 
-static Expr *parse_unary_expr(Parser *p)
+static Expr *parse_unary_expr1(Parser *p)
 {
 	Expr *e = parse_primary_expr(p);
 	if (e)
@@ -456,7 +651,16 @@ static Expr *parse_unary_expr(Parser *p)
 	return NULL;
 }
 
-static Expr *parse_cast_expr(Parser *p)
+static Expr *parse_unary_expr(Parser *p)
+{
+	F(p->nesting < NEST_MAX);
+	p->nesting++;
+	Expr *e = parse_unary_expr1(p);
+	p->nesting--;
+	return e;
+}
+
+static Expr *parse_cast_expr1(Parser *p)
 {
 	match(p, TOK_EXTENSION);
 	if (match(p, '(')) {
@@ -478,326 +682,120 @@ static Expr *parse_cast_expr(Parser *p)
 	return parse_unary_expr(p);
 }
 
-static Expr *applyBOP(ExprBinOp op, Expr *a, Expr *b)
-{
-	if (b) {
-		return exprBOP(op, a, b);
-	} else {
-		return NULL;
-	}
-}
-
-static Expr *parse_expr_post(Parser *p, Expr *e, int prec)
-{
-	if (prec < 17)
-		return e;
-
-	while (e) {
-		switch (P) {
-		case ',':
-			N; e = applyBOP(EXPR_OP_COMMA, e, parse_assignment_expr(p)); break;
-		default:
-			return e;
-		}
-	}
-	return e;
-}
-
-static Expr *parse_assignment_expr_post(Parser *p, Expr *e, int prec)
-{
-	if (prec < 16)
-		return e;
-
-	if (!e)
-		return NULL;
-
-	switch (P) {
-	case '=':
-		N; e = applyBOP(EXPR_OP_ASSIGN, e, parse_assignment_expr(p)); break;
-	case TOK_ASSIGNMUL:
-		N; e = applyBOP(EXPR_OP_ASSIGNMUL, e, parse_assignment_expr(p)); break;
-	case TOK_ASSIGNDIV:
-		N; e = applyBOP(EXPR_OP_ASSIGNDIV, e, parse_assignment_expr(p)); break;
-	case TOK_ASSIGNMOD:
-		N; e = applyBOP(EXPR_OP_ASSIGNMOD, e, parse_assignment_expr(p)); break;
-	case TOK_ASSIGNADD:
-		N; e = applyBOP(EXPR_OP_ASSIGNADD, e, parse_assignment_expr(p)); break;
-	case TOK_ASSIGNSUB:
-		N; e = applyBOP(EXPR_OP_ASSIGNSUB, e, parse_assignment_expr(p)); break;
-	case TOK_ASSIGNBSHL:
-		N; e = applyBOP(EXPR_OP_ASSIGNBSHL, e, parse_assignment_expr(p)); break;
-	case TOK_ASSIGNBSHR:
-		N; e = applyBOP(EXPR_OP_ASSIGNBSHR, e, parse_assignment_expr(p)); break;
-	case TOK_ASSIGNBAND:
-		N; e = applyBOP(EXPR_OP_ASSIGNBAND, e, parse_assignment_expr(p)); break;
-	case TOK_ASSIGNBXOR:
-		N; e = applyBOP(EXPR_OP_ASSIGNBXOR, e, parse_assignment_expr(p)); break;
-	case TOK_ASSIGNBOR:
-		N; e = applyBOP(EXPR_OP_ASSIGNBOR, e, parse_assignment_expr(p)); break;
-	default:;
-	}
-	return parse_expr_post(p, e, prec);
-}
-
-static Expr *parse_conditional_expr_post(Parser *p, Expr *cond, int prec)
-{
-	if (prec < 15)
-		return cond;
-
-	if (cond) {
-		if (match(p, '?')) {
-			Expr *e1, *e2;
-			if (match(p, ':')) {
-				// gcc extension: cond ?: expr
-				// CAN NOT CONVERT TO: cond ? cond : expr
-				e1 = NULL;
-			} else {
-				F(e1 = parse_expr(p));
-				F(match(p, ':'));
-			}
-			F(e2 = parse_conditional_expr(p));
-			return parse_assignment_expr_post(p, exprCOND(cond, e1, e2), prec);
-		} else {
-			return parse_assignment_expr_post(p, cond, prec);
-		}
-	}
-	return NULL;
-}
-
-static Expr *parse_or_expr_post(Parser *p, Expr *e, int prec)
-{
-	if (prec < 14)
-		return e;
-
-	while (e) {
-		switch (P) {
-		case TOK_OR:
-			N; e = applyBOP(EXPR_OP_OR, e, parse_and_expr(p)); break;
-		default:
-			return parse_conditional_expr_post(p, e, prec);
-		}
-	}
-	return e;
-}
-
-static Expr *parse_and_expr_post(Parser *p, Expr *e, int prec)
-{
-	if (prec < 13)
-		return e;
-
-	while (e) {
-		switch (P) {
-		case TOK_AND:
-			N; e = applyBOP(EXPR_OP_AND, e, parse_bor_expr(p)); break;
-		default:
-			return parse_or_expr_post(p, e, prec);
-		}
-	}
-	return e;
-}
-
-static Expr *parse_bor_expr_post(Parser *p, Expr *e, int prec)
-{
-	if (prec < 12)
-		return e;
-
-	while (e) {
-		switch (P) {
-		case '|':
-			N; e = applyBOP(EXPR_OP_BOR, e, parse_bxor_expr(p)); break;
-		default:
-			return parse_and_expr_post(p, e, prec);
-		}
-	}
-	return e;
-}
-
-static Expr *parse_bxor_expr_post(Parser *p, Expr *e, int prec)
-{
-	if (prec < 11)
-		return e;
-
-	while (e) {
-		switch (P) {
-		case '^':
-			N; e = applyBOP(EXPR_OP_BXOR, e, parse_band_expr(p)); break;
-		default:
-			return parse_bor_expr_post(p, e, prec);
-		}
-	}
-	return e;
-}
-
-static Expr *parse_band_expr_post(Parser *p, Expr *e, int prec)
+static Expr *parse_cast_expr(Parser *p)
 {
-	if (prec < 10)
-		return e;
-
-	while (e) {
-		switch (P) {
-		case '&':
-			N; e = applyBOP(EXPR_OP_BAND, e, parse_equality_expr(p)); break;
-		default:
-			return parse_bxor_expr_post(p, e, prec);
-		}
-	}
+	F(p->nesting < NEST_MAX);
+	p->nesting++;
+	Expr *e = parse_cast_expr1(p);
+	p->nesting--;
 	return e;
 }
 
-static Expr *parse_equality_expr_post(Parser *p, Expr *e, int prec)
-{
-	if (prec < 9)
-		return e;
-
-	while (e) {
-		switch (P) {
-		case TOK_EQ:
-			N; e = applyBOP(EXPR_OP_EQ, e, parse_relational_expr(p)); break;
-		case TOK_NEQ:
-			N; e = applyBOP(EXPR_OP_NEQ, e, parse_relational_expr(p)); break;
-		default:
-			return parse_band_expr_post(p, e, prec);
-		}
-	}
-	return e;
-}
+/* binary operators by token.  Levels 5 to 14 are left associative,
+   conditionals (15) and assignments (16) right associative, and the
+   comma (17) left associative again. */
+static const struct binop {
+	unsigned char prec;
+	unsigned char op;
+	bool right;
+} binops[TOK_END] = {
+	['*'] = { 5, EXPR_OP_MUL },
+	['/'] = { 5, EXPR_OP_DIV },
+	['%'] = { 5, EXPR_OP_MOD },
+	['+'] = { 6, EXPR_OP_ADD },
+	['-'] = { 6, EXPR_OP_SUB },
+	[TOK_BSHL] = { 7, EXPR_OP_BSHL },
+	[TOK_BSHR] = { 7, EXPR_OP_BSHR },
+	['<'] = { 8, EXPR_OP_LT },
+	['>'] = { 8, EXPR_OP_GT },
+	[TOK_LE] = { 8, EXPR_OP_LE },
+	[TOK_GE] = { 8, EXPR_OP_GE },
+	[TOK_EQ] = { 9, EXPR_OP_EQ },
+	[TOK_NEQ] = { 9, EXPR_OP_NEQ },
+	['&'] = { 10, EXPR_OP_BAND },
+	['^'] = { 11, EXPR_OP_BXOR },
+	['|'] = { 12, EXPR_OP_BOR },
+	[TOK_AND] = { 13, EXPR_OP_AND },
+	[TOK_OR] = { 14, EXPR_OP_OR },
+	['?'] = { 15, 0, true },
+	['='] = { 16, EXPR_OP_ASSIGN, true },
+	[TOK_ASSIGNMUL] = { 16, EXPR_OP_ASSIGNMUL, true },
+	[TOK_ASSIGNDIV] = { 16, EXPR_OP_ASSIGNDIV, true },
+	[TOK_ASSIGNMOD] = { 16, EXPR_OP_ASSIGNMOD, true },
+	[TOK_ASSIGNADD] = { 16, EXPR_OP_ASSIGNADD, true },
+	[TOK_ASSIGNSUB] = { 16, EXPR_OP_ASSIGNSUB, true },
+	[TOK_ASSIGNBSHL] = { 16, EXPR_OP_ASSIGNBSHL, true },
+	[TOK_ASSIGNBSHR] = { 16, EXPR_OP_ASSIGNBSHR, true },
+	[TOK_ASSIGNBAND] = { 16, EXPR_OP_ASSIGNBAND, true },
+	[TOK_ASSIGNBXOR] = { 16, EXPR_OP_ASSIGNBXOR, true },
+	[TOK_ASSIGNBOR] = { 16, EXPR_OP_ASSIGNBOR, true },
+	[','] = { 17, EXPR_OP_COMMA },
+};
 
-static Expr *parse_relational_expr_post(Parser *p, Expr *e, int prec)
+// the operator at the lookahead, if it is at level prec or below
+static const struct binop *peek_binop(Parser *p, int prec)
 {
-	if (prec < 8)
-		return e;
-
-	while (e) {
-		switch (P) {
-		case '<':
-			N; e = applyBOP(EXPR_OP_LT, e, parse_shift_expr(p)); break;
-		case '>':
-			N; e = applyBOP(EXPR_OP_GT, e, parse_shift_expr(p)); break;
-		case TOK_LE:
-			N; e = applyBOP(EXPR_OP_LE, e, parse_shift_expr(p)); break;
-		case TOK_GE:
-			N; e = applyBOP(EXPR_OP_GE, e, parse_shift_expr(p)); break;
-		default:
-			return parse_equality_expr_post(p, e, prec);
-		}
-	}
-	return e;
+	int tok = P;
+	if (tok >= TOK_END || !binops[tok].prec || binops[tok].prec > prec)
+		return NULL;
+	return &binops[tok];
 }
 
-static Expr *parse_shift_expr_post(Parser *p, Expr *e, int prec)
+// builds the operator on top of the stack with its right operand
+static Expr *reduce(Parser *p, Expr *b)
 {
-	if (prec < 7)
-		return e;
-
-	while (e) {
-		switch (P) {
-		case TOK_BSHL:
-			N; e = applyBOP(EXPR_OP_BSHL, e, parse_additive_expr(p)); break;
-		case TOK_BSHR:
-			N; e = applyBOP(EXPR_OP_BSHR, e, parse_additive_expr(p)); break;
-		default:
-			return parse_relational_expr_post(p, e, prec);
-		}
-	}
-	return e;
+	BinOpItem it = vec_pop(&p->binops);
+	if (it.prec == 15)
+		return exprCOND(it.a, it.mid, b);
+	return exprBOP(it.op, it.a, b);
 }
 
-static Expr *parse_additive_expr_post(Parser *p, Expr *e, int prec)
+/* continues the operand e with operators up to level prec, by
+   precedence climbing.  An operator waits on the stack for its right
+   operand until a looser one comes, so chains on either side don't
+   recurse. */
+static Expr *parse_expr_post(Parser *p, Expr *e, int prec)
 {
-	if (prec < 6)
-		return e;
-
-	while (e) {
-		switch (P) {
-		case '+':
-			N; e = applyBOP(EXPR_OP_ADD, e, parse_multiplicative_expr(p)); break;
-		case '-':
-			N; e = applyBOP(EXPR_OP_SUB, e, parse_multiplicative_expr(p)); break;
-		default:
-			return parse_shift_expr_post(p, e, prec);
+	int base = p->binops.length;
+	const struct binop *b;
+
+	while (e && (b = peek_binop(p, prec))) {
+		while (p->binops.length > base &&
+		       (vec_last(&p->binops).prec < b->prec ||
+			(vec_last(&p->binops).prec == b->prec && !b->right)))
+			e = reduce(p, e);
+		N;
+		Expr *mid = NULL;
+		// gcc extension: cond ?: expr
+		// CAN NOT CONVERT TO: cond ? cond : expr
+		if (b->prec == 15 && !match(p, ':')) {
+			mid = parse_expr(p);
+			if (!mid || !match(p, ':')) {
+				e = NULL;
+				break;
+			}
 		}
+		BinOpItem it = { e, mid, b->op, b->prec };
+		vec_push(&p->binops, it);
+		e = parse_cast_expr(p);
 	}
-	return e;
-}
-
-static Expr *parse_multiplicative_expr_post(Parser *p, Expr *e, int prec)
-{
-	if (prec < 5)
-		return e;
-
-	while (e) {
-		switch (P) {
-		case '*':
-			N; e = applyBOP(EXPR_OP_MUL, e, parse_cast_expr(p)); break;
-		case '/':
-			N; e = applyBOP(EXPR_OP_DIV, e, parse_cast_expr(p)); break;
-		case '%':
-			N; e = applyBOP(EXPR_OP_MOD, e, parse_cast_expr(p)); break;
-		default:
-			return parse_additive_expr_post(p, e, prec);
-		}
+	if (!e) {
+		p->binops.length = base;
+		return NULL;
 	}
+	while (p->binops.length > base)
+		e = reduce(p, e);
 	return e;
 }
 
-static Expr *parse_multiplicative_expr(Parser *p)
-{
-	return parse_multiplicative_expr_post(p, parse_cast_expr(p), 5);
-}
-
-static Expr *parse_additive_expr(Parser *p)
-{
-	return parse_additive_expr_post(p, parse_multiplicative_expr(p), 6);
-}
-
-static Expr *parse_shift_expr(Parser *p)
-{
-	return parse_shift_expr_post(p, parse_additive_expr(p), 7);
-}
-
-static Expr *parse_relational_expr(Parser *p)
-{
-	return parse_relational_expr_post(p, parse_shift_expr(p), 8);
-}
-
-static Expr *parse_equality_expr(Parser *p)
-{
-	return parse_equality_expr_post(p, parse_relational_expr(p), 9);
-}
-
-static Expr *parse_band_expr(Parser *p)
-{
-	return parse_band_expr_post(p, parse_equality_expr(p), 10);
-}
-
-static Expr *parse_bxor_expr(Parser *p)
-{
-	return parse_bxor_expr_post(p, parse_band_expr(p), 11);
-}
-
-static Expr *parse_bor_expr(Parser *p)
-{
-	return parse_bor_expr_post(p, parse_bxor_expr(p), 12);
-}
-
-static Expr *parse_and_expr(Parser *p)
-{
-	return parse_and_expr_post(p, parse_bor_expr(p), 13);
-}
-
-static Expr *parse_or_expr(Parser *p)
-{
-	return parse_or_expr_post(p, parse_and_expr(p), 14);
-}
-
 static Expr *parse_conditional_expr(Parser *p)
 {
-	return parse_conditional_expr_post(p, parse_or_expr(p), 15);
+	return parse_expr_post(p, parse_cast_expr(p), 15);
 }
 
 static Expr *parse_assignment_expr(Parser *p)
 {
-	return parse_assignment_expr_post(p, parse_conditional_expr(p), 16);
+	return parse_expr_post(p, parse_cast_expr(p), 16);
 }
 
 typedef struct {
@@ -929,7 +927,7 @@ static int parse_declarator0(Parser *p, Declarator *d)
 			bool is_static = false;
 			if (match(p, '*')) {
 				if(!match(p, ']')) {
-					F(e = parse_multiplicative_expr_post(
+					F(e = parse_expr_post(
 						  p, applyUOP(EXPR_OP_DEREF, parse_cast_expr(p)), 16));
 					F(match(p, ']'));
 				}
@@ -1355,12 +1353,319 @@ static Declarator parse_type1(Parser *p, Type **pbtype, Attribute *attrs, bool i
 	return err;
 }
 
+// parser state at the start of an item, to go back to on an error
+typedef struct {
+	LexerMark mark;
+	struct scope_item *scopes;
+	int binops;
+	int managed_count;
+} Restart;
+
+static void restart_here(Parser *p, Restart *r)
+{
+	r->mark = lexer_mark(p->lexer);
+	r->scopes = p->scopes;
+	r->binops = p->binops.length;
+	r->managed_count = p->managed_count;
+}
+
+/* passes over an item whose syntax is unknown: up to a ';' outside
+   brackets, or the '}' closing a body.  A '}' that closes nothing ends
+   the enclosing block, unless at top level. */
+static void skip_item(Parser *p, bool top)
+{
+	int depth = 0, prev = 0;
+	bool body = false;
+	while (P != TOK_END) {
+		int t = P;
+		if (t == '}' && depth == 0) {
+			if (top)
+				N;
+			return;
+		}
+		LexerMark m = lexer_mark(p->lexer);
+		N;
+		if (t == TOK_ERROR) {
+			// the lexer may not get past a bad token
+			LexerMark m1 = lexer_mark(p->lexer);
+			if (m1.off == m.off)
+				return;
+		}
+		switch (t) {
+		case '{':
+			if (depth++ == 0)
+				body = !prev || prev == ')' || prev == ':' ||
+					prev == TOK_ELSE || prev == TOK_DO ||
+					prev == TOK_MANAGED;
+			break;
+		case '(':
+		case '[':
+			depth++;
+			break;
+		case '}':
+			if (--depth == 0 && body)
+				return;
+			break;
+		case ')':
+		case ']':
+			if (depth)
+				depth--;
+			break;
+		case ';':
+			if (depth == 0)
+				return;
+			break;
+		}
+		prev = t;
+	}
+}
+
+/* after a syntax error in the item started at r, records the error and
+   returns the item's text as is */
+static Stmt *parse_opaque(Parser *p, Restart *r, bool top)
+{
+	F(p->recover && !p->over);
+	ParseError e = {
+		strdup(lexer_report_path(p->lexer)),
+		lexer_report_line(p->lexer),
+	};
+	vec_push(&p->errors, e);
+
+	while (p->scopes != r->scopes)
+		leave_scope(p);
+	p->binops.length = r->binops;
+	p->managed_count = r->managed_count;
+	lexer_rewind(p->lexer, r->mark);
+	SrcLoc loc = loc_here(p);
+	skip_item(p, top);
+
+	long len;
+	const char *text = lexer_text_since(p->lexer, r->mark, &len);
+	F(len > 0);
+	Stmt *s = stmtOPAQUE(text, len);
+	loc_record(p, s, loc);
+	return s;
+}
+
+// what a bracket opens in a skimmed item
+enum {
+	SK_DECL = 1,	// a parenthesized declarator
+	SK_OTHER,	// parameters, attributes, sizes, initializers
+	SK_BODY,	// a function body
+	SK_AGGR,	// struct or union members
+	SK_ENUM,	// enumerators
+};
+
+#define SKIM_DEPTH 64
+
+static bool skim_type_keyword(int t)
+{
+	switch (t) {
+	case TOK_VOID: case TOK_INT: case TOK_LONG: case TOK_SHORT:
+	case TOK_CHAR: case TOK_SIGNED: case TOK_UNSIGNED: case TOK_FLOAT:
+	case TOK_DOUBLE: case TOK_BOOL: case TOK_COMPLEX: case TOK_IMAGINARY:
+	case TOK_INT128: case TOK_AUTOTYPE: case TOK_TYPEOF:
+	case TOK_TYPEOFUNQUAL: case TOK_STRUCT: case TOK_UNION: case TOK_ENUM:
+		return true;
+	}
+	return false;
+}
+
+// keywords taking a parenthesized argument
+static bool skim_call_keyword(int t)
+{
+	switch (t) {
+	case TOK_ATTRIBUTE: case TOK_ASM: case TOK_TYPEOF: case TOK_TYPEOFUNQUAL:
+	case TOK_ALIGNAS: case TOK_ALIGNOF: case TOK_ATOMIC: case TOK_SIZEOF:
+	case TOK_STATICASSERT: case TOK_GENERIC:
+		return true;
+	}
+	return false;
+}
+
+static bool is_alias_name(const char *s)
+{
+	return s && (!strcmp(s, "alias") || !strcmp(s, "__alias__"));
+}
+
+/* takes a top-level item by its tokens alone.  A declarator's name is
+   its first identifier outside parameter lists that is not a type
+   name; typedefs and enumerators still go into the symbol table. */
+static Stmt *parse_skim(Parser *p)
+{
+	LexerMark m = lexer_mark(p->lexer);
+	SrcLoc loc = loc_here(p);
+	StmtSKIM *s = stmtSKIM();
+	char kinds[SKIM_DEPTH];
+	int depth = 0, ndecl = 0;	// open brackets, the declarator ones
+	int prev = 0, sv = SYM_IDENT;
+	// a struct, union or enum waiting for its tag or body
+	int tagkw = 0, tagdepth = 0;
+	const char *tag = NULL;
+	// the names of __attribute__((...)) are at attrdepth + 1
+	int attrdepth = 0;
+	const char *attr = NULL, *name = NULL;
+	bool spec = false, named = false, init = false;
+
+	while (P != TOK_END) {
+		int t = P;
+		int top = depth ? kinds[(depth < SKIM_DEPTH ? depth : SKIM_DEPTH) - 1] : 0;
+		bool decl = depth == ndecl && !init;
+		// a declarator name followed by parameters is a function
+		if (name) {
+			s->flags |= t == '(' ? SKIM_FUN : SKIM_VAR;
+			name = NULL;
+		}
+		if (tagkw && depth == tagdepth && t != TOK_ATTRIBUTE &&
+		    !(t == '(' && prev == TOK_ATTRIBUTE)) {
+			if (t == TOK_IDENT && !tag) {
+				tag = get_and_next(p);
+				prev = t;
+				continue;
+			}
+			if (tag) {
+				if (t == '{' || t == ';')
+					stmtSKIM_append_def(s, tag);
+				else
+					stmtSKIM_append_use(s, tag);
+			}
+			if (t == '{') {
+				if (depth < SKIM_DEPTH)
+					kinds[depth] = tagkw == TOK_ENUM ? SK_ENUM : SK_AGGR;
+				depth++;
+				tagkw = 0;
+				prev = t;
+				N;
+				continue;
+			}
+			tagkw = 0;
+		}
+		if (attrdepth && depth == attrdepth + 1 &&
+		    (prev == '(' || prev == ',') &&
+		    (t == TOK_IDENT ||
+		     (t > TOK_KEYWORD_START && t < TOK_KEYWORD_END))) {
+			attr = get_and_next(p);
+			stmtSKIM_append_attr(s, attr);
+			prev = TOK_IDENT;
+			continue;
+		}
+		if (t == TOK_IDENT) {
+			const char *id = get_and_next(p);
+			if (top == SK_ENUM && (prev == '{' || prev == ',')) {
+				stmtSKIM_append_def(s, id);
+				symdef(p, id, SYM_IDENT);
+			} else if (decl && !named &&
+				   (spec || symlookup(p, id) != SYM_TYPE)) {
+				stmtSKIM_append_def(s, id);
+				symdef(p, id, sv);
+				named = spec = true;
+				name = id;
+			} else {
+				stmtSKIM_append_use(s, id);
+				if (decl)
+					spec = true;
+			}
+			prev = t;
+			continue;
+		}
+
+		int open = 0;
+		switch (t) {
+		case '(':
+			open = decl && !named && spec && !skim_call_keyword(prev) ?
+				SK_DECL : SK_OTHER;
+			if (prev == TOK_ATTRIBUTE)
+				attrdepth = depth + 1;
+			break;
+		case '[':
+			open = SK_OTHER;
+			break;
+		case '{':
+			open = decl ? SK_BODY : SK_OTHER;
+			if (decl)
+				s->flags |= SKIM_BODY;
+			break;
+		case ')':
+		case ']':
+		case '}':
+			if (!depth)
+				break;
+			if (top == SK_DECL)
+				ndecl--;
+			if (--depth < attrdepth)
+				attrdepth = 0;
+			if (top == SK_BODY && depth == 0) {
+				N;
+				goto done;
+			}
+			break;
+		case ';':
+			if (depth == 0) {
+				N;
+				goto done;
+			}
+			break;
+		case ',':
+			if (depth == 0)
+				named = init = false;
+			break;
+		case '=':
+			if (decl)
+				init = true;
+			break;
+		case TOK_TYPEDEF:
+			s->flags |= SKIM_TYPEDEF;
+			sv = SYM_TYPE;
+			break;
+		case TOK_EXTERN:
+			s->flags |= SKIM_EXTERN;
+			break;
+		case TOK_STATIC:
+			s->flags |= SKIM_STATIC;
+			break;
+		case TOK_STRUCT:
+		case TOK_UNION:
+		case TOK_ENUM:
+			tagkw = t;
+			tagdepth = depth;
+			tag = NULL;
+			break;
+		case TOK_STRING_CST:
+			// the target of an alias is spelled as a string
+			if (attrdepth && is_alias_name(attr))
+				stmtSKIM_append_use(s, __new_cstring(PS));
+			break;
+		}
+		if (decl && (skim_type_keyword(t) ||
+			     (t == '(' && prev == TOK_ATOMIC)))
+			spec = true;
+		if (open) {
+			if (depth < SKIM_DEPTH)
+				kinds[depth] = open;
+			depth++;
+			if (open == SK_DECL)
+				ndecl++;
+		}
+		prev = t;
+		N;
+	}
+done:;
+	long len;
+	s->text = lexer_text_since(p->lexer, m, &len);
+	s->len = len;
+	loc_record(p, (Stmt *) s, loc);
+	return (Stmt *) s;
+}
+
 static StmtBLOCK *parse_stmts(Parser *p)
 {
 	StmtBLOCK *block = stmtBLOCK();
 	while (P != '}' && P != TOK_END) {
 		Stmt *s;
-		F(s = parse_stmt(p));
+		Restart r;
+		restart_here(p, &r);
+		if (!(s = parse_stmt(p)))
+			F(s = parse_opaque(p, &r, false));
 		stmtBLOCK_append(block, s);
 	}
 	return block;
@@ -1377,13 +1682,81 @@ static StmtBLOCK *parse_block_stmt(Parser *p)
 	return block;
 }
 
+// what parse_fundecl_body() needs to go back to a lazy body
+typedef struct {
+	LexerMark mark;
+	const char *path;
+	int flags;
+	struct scope_item *scopes;
+	int managed_count;
+} LazyBody;
+
+/* passes over a function body by matching its braces, keeping the
+   text and the identifiers for a StmtLAZY.  The parameter scope stays
+   reachable from it, so the parser must have an allocator. */
+static StmtBLOCK *skip_block_stmt(Parser *p)
+{
+	LazyBody *r = __new(LazyBody);
+	r->mark = lexer_mark(p->lexer);
+	r->path = __new_cstring(lexer_report_path(p->lexer));
+	r->flags = lexer_report_flags(p->lexer);
+	r->scopes = p->scopes;
+	r->managed_count = p->managed_count;
+	F(match(p, '{'));
+
+	LexerMark m = lexer_mark(p->lexer);
+	SrcLoc loc = loc_here(p);
+	StmtLAZY *s = stmtLAZY(r);
+	int depth = 0, prev = 0;
+	while (P != TOK_END && (P != '}' || depth)) {
+		int t = P;
+		F(t != TOK_ERROR);
+		if (t == TOK_IDENT) {
+			const char *id = get_and_next(p);
+			if (prev != '.' && prev != TOK_PMEM)
+				stmtLAZY_append_use(s, id);
+			prev = t;
+			continue;
+		}
+		if (t == '{')
+			depth++;
+		else if (t == '}')
+			depth--;
+		prev = t;
+		N;
+	}
+	long len;
+	s->text = lexer_text_since(p->lexer, m, &len);
+	s->len = len;
+	F(match(p, '}'));
+	loc_record(p, (Stmt *) s, loc);
+
+	StmtBLOCK *block = stmtBLOCK();
+	stmtBLOCK_append(block, (Stmt *) s);
+	return block;
+}
+
 static bool parse_decl_(Parser *p, Stmt **pstmt, bool in_struct, bool in_for99, bool implicit_int);
+static Stmt *parse_decls_item(Parser *p, bool in_struct, bool implicit_int)
+{
+	Stmt *s;
+	SrcLoc loc = loc_here(p);
+	F(parse_decl_(p, &s, in_struct, false, implicit_int) && s);
+	if (!in_struct)
+		loc_record(p, s, loc);
+	return s;
+}
+
 static StmtBLOCK *parse_decls(Parser *p, bool in_struct, bool implicit_int)
 {
 	StmtBLOCK *block = stmtBLOCK();
-	while (P != '}' && P != TOK_END) {
+	while ((P != '}' || (!in_struct && p->recover)) && P != TOK_END) {
 		Stmt *s;
-		F(parse_decl_(p, &s, in_struct, false, implicit_int) && s);
+		// only struct members and the translation unit come here
+		if (in_struct)
+			F(s = parse_decls_item(p, in_struct, implicit_int));
+		else
+			F(s = parse_external_decl(p));
 		stmtBLOCK_append(block, s);
 	}
 	return block;
@@ -1397,6 +1770,8 @@ static bool match_initialzer_item(Parser *p, ExprINIT *init)
 		if (match(p, '[')) {
 			n = __new(Designator);
 			n->type = DES_INDEX;
+			n->field = NULL;
+			n->indexhigh = NULL;
 			F(n->index = parse_expr(p));
 			if (match(p, TOK_DOT3)) {
 				F(n->indexhigh = parse_expr(p));
@@ -1406,6 +1781,7 @@ static bool match_initialzer_item(Parser *p, ExprINIT *init)
 		} else if (match(p, '.')) {
 			n = __new(Designator);
 			n->type = DES_FIELD;
+			n->index = n->indexhigh = NULL;
 			F(P == TOK_IDENT);
 			n->field = get_and_next(p);
 		} else {
@@ -1430,6 +1806,42 @@ static bool match_initialzer_item(Parser *p, ExprINIT *init)
 	return true;
 }
 
+// shorter lists are left as they are
+#define PACK_MIN 64
+
+/* a list of int constants, or of unsigned int ones, and its '}' as an
+   ExprINITPACK; otherwise NULL, back at the first item */
+static Expr *parse_packed_initializer(Parser *p)
+{
+	LexerMark m = lexer_mark(p->lexer);
+	int kind = P == TOK_UINT_CST ? TOK_UINT_CST : TOK_INT_CST;
+	p->packed.length = 0;
+	while (true) {
+		bool neg = kind == TOK_INT_CST && P == '-';
+		if (neg)
+			N;
+		if (P != kind)
+			break;
+		int v = PI;
+		N;
+		vec_push(&p->packed, neg ? -v : v);
+		if (!match(p, ',') && P != '}')
+			break;
+		if (P == '}') {
+			if (p->packed.length < PACK_MIN)
+				break;
+			N;
+			return (Expr *) exprINITPACK(
+				kind == TOK_INT_CST ? EXPR_INT_CST : EXPR_UINT_CST,
+				p->packed.data, p->packed.length);
+		}
+	}
+	// over budget, the input stays ended
+	if (!p->over)
+		lexer_rewind(p->lexer, m);
+	return NULL;
+}
+
 static Expr *parse_initializer(Parser *p)
 {
 	if (match(p, '{')) {
@@ -1437,6 +1849,11 @@ static Expr *parse_initializer(Parser *p)
 		if (match(p, '}')) {
 			return (Expr *) init;
 		}
+		if (P == TOK_INT_CST || P == TOK_UINT_CST || P == '-') {
+			Expr *e = parse_packed_initializer(p);
+			if (e)
+				return e;
+		}
 
 		F(match_initialzer_item(p, init));
 		while (match(p, ',')) {
@@ -1508,7 +1925,10 @@ Stmt *parse_decl0(Parser *p, Declarator d, Type *btype, bool in_struct)
 		F(parse_gnu_attribute(p, &attrs));
 		StmtBLOCK *b;
 		restore_scope(p, d.funscope);
-		b = parse_block_stmt(p);
+		if (p->lazy && p->allocator)
+			b = skip_block_stmt(p);
+		else
+			b = parse_block_stmt(p);
 		leave_scope(p);
 		F(b);
 		if (p->managed_count)
@@ -1618,7 +2038,11 @@ static bool parse_decl_(Parser *p, Stmt **pstmt, bool in_struct, bool in_for99,
 		StmtDECLS *decls = stmtDECLS();
 		while (P != '}' && P != TOK_END) {
 			Stmt *stmt;
-			F(parse_decl_(p, &stmt, in_struct, false, implicit_int) && stmt);
+			Restart r;
+			restart_here(p, &r);
+			if (!parse_decl_(p, &stmt, in_struct, false, implicit_int) ||
+			    !stmt)
+				F(!in_struct && (stmt = parse_opaque(p, &r, false)));
 			stmtDECLS_append(decls, stmt);
 		}
 		F(match(p, '}'));
@@ -1683,7 +2107,16 @@ bool parse_decl(Parser *p, Stmt **pstmt)
 	return parse_decl_(p, pstmt, false, false, false);
 }
 
+static Stmt *parse_stmt_(Parser *p);
 Stmt *parse_stmt(Parser *p)
+{
+	SrcLoc loc = loc_here(p);
+	Stmt *s = parse_stmt_(p);
+	loc_record(p, s, loc);
+	return s;
+}
+
+static Stmt *parse_stmt_(Parser *p)
 {
 	switch (P) {
 	case TOK_IF: {
@@ -1827,6 +2260,7 @@ Stmt *parse_stmt(Parser *p)
 	default: {
 		Expr *e;
 		if (P == TOK_IDENT) {
+			int builtin = lexer_peek_builtin(p->lexer);
 			const char *id = get_and_next(p);
 			if (match(p, ':')) {
 				// a label
@@ -1849,7 +2283,7 @@ Stmt *parse_stmt(Parser *p)
 				if (old_count != new_count)
 					return decl;
 				// maybe an expression
-				Expr *e0 = parse_ident_or_builtin(p, id);
+				Expr *e0 = parse_ident_or_builtin(p, id, builtin);
 				e = parse_postfix_expr_post(p, e0, 17);
 			}
 		} else {
@@ -1880,8 +2314,7 @@ Type *parse_type(Parser *p)
 
 Expr *parse_expr(Parser *p)
 {
-	Expr *e = parse_assignment_expr(p);
-	return parse_expr_post(p, e, 17);
+	return parse_expr_post(p, parse_cast_expr(p), 17);
 }
 
 StmtBLOCK *parse_translation_unit(Parser *p)
@@ -1896,4 +2329,64 @@ StmtBLOCK *parse_translation_unit(Parser *p)
 	return s;
 }
 
+StmtBLOCK *parse_fundecl_body(Parser *p, StmtFUNDECL *s)
+{
+	StmtBLOCK *b = s->body;
+	if (!b || b->items.length != 1 || b->items.data[0]->type != STMT_LAZY)
+		return b;
+	LazyBody *r = ((StmtLAZY *) b->items.data[0])->resume;
+
+	// the parser is somewhere after the body; come back there
+	LexerMark here = lexer_mark(p->lexer);
+	const char *path = __new_cstring(lexer_report_path(p->lexer));
+	int flags = lexer_report_flags(p->lexer);
+	struct scope_item *scopes = p->scopes;
+	int binops = p->binops.length;
+	int managed_count = p->managed_count;
+	// the tokens were counted when the body was skipped
+	int next_count = p->next_count;
+	long token_limit = p->token_limit;
+	p->token_limit = 0;
+	budget_next(p);
+
+	p->scopes = r->scopes;
+	p->managed_count = r->managed_count;
+	lexer_rewind_path(p->lexer, r->mark, r->path, r->flags);
+	b = parse_block_stmt(p);
+
+	p->scopes = scopes;
+	p->binops.length = binops;
+	p->managed_count = managed_count;
+	p->next_count = next_count;
+	p->token_limit = token_limit;
+	if (p->over)
+		return NULL;
+	budget_next(p);
+	lexer_rewind_path(p->lexer, here, path, flags);
+	if (b) {
+		s->body = b;
+	} else {
+		// the text stays, as after any other syntax error
+		ParseError e = { strdup(r->path), r->mark.line };
+		vec_push(&p->errors, e);
+	}
+	return b;
+}
+
+Stmt *parse_external_decl(Parser *p)
+{
+	if ((P == '}' && !p->recover) || P == TOK_END)
+		return NULL;
+	if (p->skim && P != TOK_PP_PRAGMA_LINE &&
+	    lexer_in_system_header(p->lexer))
+		return parse_skim(p);
+	Restart r;
+	restart_here(p, &r);
+	Stmt *s = parse_decls_item(p, false, true);
+	if (!s)
+		s = parse_opaque(p, &r, true);
+	return s;
+}
+
 END_MANAGED
+#include "parser-reparse.inc"
@@ -2,32 +2,307 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <assert.h>
-#include <math.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include "vec.h"
+#include "srcloc.h"
 
 struct Printer_
 {
 	bool print_type_annot;
+	bool minimal_parens;
+	bool compact;
+	int cstate;
+	char clast, cquote;
+	bool cspace, cnumber;
+	LocTable *locs;
+	// files of the line markers printed, the main file first
+	vec_int_t lstack;
+	// output line lbase is line lline of the file on top of lstack,
+	// unless markers in kept text have moved it
+	bool lsync;
+	int lline;
+	long nlines, lbase;
+	// output is collected by the caller (parallel printing)
+	bool hold;
+	vec_char_t buf;
+	long written;
+	// operators of the binary chains being printed
+	vec_t(ExprBOP *) spine;
 };
 
-static void decl_flags_print(unsigned int flags)
+#define PRINTER_FLUSH 65536
+
+static void printer_flush(Printer *self)
+{
+	fwrite(self->buf.data, 1, self->buf.length, stdout);
+	self->written += self->buf.length;
+	vec_clear(&self->buf);
+}
+
+static char *out_reserve(Printer *self, int n)
+{
+	vec_reserve_po2_(vec_unpack_(&self->buf), self->buf.length + n);
+	return self->buf.data + self->buf.length;
+}
+
+enum {
+	CS_CODE,
+	CS_SLASH,
+	CS_COMMENT,
+	CS_COMMENT_STAR,
+	CS_LINE_COMMENT,
+	CS_LITERAL,
+	CS_LITERAL_ESC,
+	CS_DIRECTIVE,
+};
+
+static bool is_idchar(unsigned char c)
+{
+	return c == '_' || c == '$' || c >= 0x80 ||
+		(c >= '0' && c <= '9') ||
+		((c | 0x20) >= 'a' && (c | 0x20) <= 'z');
+}
+
+/* characters that would extend a punctuator ending in the index */
+static const char *const paste_next[128] = {
+	['+'] = "+=", ['-'] = "-=>", ['&'] = "&=", ['|'] = "|=",
+	['<'] = "<=:%", ['>'] = ">=", ['='] = "=", ['!'] = "=",
+	['*'] = "=/", ['/'] = "=/*", ['%'] = "=>:", ['^'] = "=",
+	['#'] = "#", [':'] = ">", ['.'] = ".0123456789",
+};
+
+static bool tokens_paste(Printer *self, unsigned char l, unsigned char c)
+{
+	if (is_idchar(l)) {
+		if (is_idchar(c) || c == '"' || c == '\'')
+			return true;
+		if (self->cnumber)
+			return c == '.' || ((c == '+' || c == '-') &&
+					    strchr("eEpP", l));
+		return false;
+	}
+	return l < 128 && paste_next[l] && c && strchr(paste_next[l], c);
+}
+
+/* output line and last character, needed by print_loc() */
+static void out_track(Printer *self, const char *s, int n)
+{
+	for (const char *q = s; (q = memchr(q, '\n', s + n - q)); q++)
+		self->nlines++;
+	if (n)
+		self->clast = s[n - 1];
+}
+
+static void compact_put(Printer *self, char c)
+{
+	*out_reserve(self, 1) = c;
+	self->buf.length++;
+	self->clast = c;
+	if (c == '\n')
+		self->nlines++;
+}
+
+/* chunks of compact output end on a full line, so that they can be
+   joined and a following line marker starts a line */
+static void compact_end_line(Printer *self)
+{
+	if (self->compact && self->clast && self->clast != '\n')
+		compact_put(self, '\n');
+}
+
+static void compact_code(Printer *self, char c)
+{
+	char l = self->clast;
+	bool adj = !self->cspace;
+	if (self->cspace) {
+		if (tokens_paste(self, l, c))
+			compact_put(self, ' ');
+		self->cspace = false;
+		self->cnumber = false;
+	}
+	if (is_idchar(c))
+		self->cnumber = adj && (is_idchar(l) || l == '.') ?
+			self->cnumber || (l == '.' && c >= '0' && c <= '9') :
+			c >= '0' && c <= '9';
+	else if (c == '+' || c == '-')
+		self->cnumber = self->cnumber && adj && strchr("eEpP", l);
+	else if (c != '.')
+		self->cnumber = false;
+	compact_put(self, c);
+}
+
+/* drop comments and whitespace that does not separate tokens;
+   literals and directives pass through unchanged */
+static void compact_char(Printer *self, char c)
+{
+	switch (self->cstate) {
+	case CS_SLASH:
+		if (c == '*') {
+			self->cstate = CS_COMMENT;
+			return;
+		}
+		if (c == '/') {
+			self->cstate = CS_LINE_COMMENT;
+			return;
+		}
+		self->cstate = CS_CODE;
+		compact_code(self, '/');
+		break;
+	case CS_COMMENT:
+		if (c == '*')
+			self->cstate = CS_COMMENT_STAR;
+		return;
+	case CS_COMMENT_STAR:
+		if (c == '/') {
+			self->cstate = CS_CODE;
+			self->cspace = true;
+		} else if (c != '*') {
+			self->cstate = CS_COMMENT;
+		}
+		return;
+	case CS_LINE_COMMENT:
+		if (c == '\n') {
+			self->cstate = CS_CODE;
+			self->cspace = true;
+		}
+		return;
+	case CS_LITERAL:
+		compact_put(self, c);
+		if (c == '\\')
+			self->cstate = CS_LITERAL_ESC;
+		else if (c == self->cquote)
+			self->cstate = CS_CODE;
+		return;
+	case CS_LITERAL_ESC:
+		compact_put(self, c);
+		self->cstate = CS_LITERAL;
+		return;
+	case CS_DIRECTIVE:
+		compact_put(self, c);
+		if (c == '\n')
+			self->cstate = CS_CODE;
+		return;
+	}
+
+	switch (c) {
+	case ' ': case '\t': case '\n':
+		self->cspace = true;
+		break;
+	case '/':
+		self->cstate = CS_SLASH;
+		break;
+	case '"': case '\'':
+		compact_code(self, c);
+		self->cquote = c;
+		self->cstate = CS_LITERAL;
+		break;
+	case '#':
+		if (self->clast && self->clast != '\n')
+			compact_put(self, '\n');
+		compact_put(self, c);
+		self->cspace = false;
+		self->cnumber = false;
+		self->cstate = CS_DIRECTIVE;
+		break;
+	default:
+		compact_code(self, c);
+		break;
+	}
+}
+
+static void outn(Printer *self, const char *s, int n)
+{
+	if (self->compact) {
+		for (int i = 0; i < n; i++) {
+			compact_char(self, s[i]);
+			/* the rest of an identifier or literal is copied as is */
+			int j = i + 1;
+			if (self->cstate == CS_CODE && !self->cspace &&
+			    is_idchar(self->clast))
+				while (j < n && is_idchar(s[j]))
+					j++;
+			else if (self->cstate == CS_LITERAL)
+				while (j < n && s[j] != self->cquote && s[j] != '\\')
+					j++;
+			if (j > i + 1) {
+				memcpy(out_reserve(self, j - i - 1), s + i + 1, j - i - 1);
+				self->buf.length += j - i - 1;
+				self->clast = s[j - 1];
+				i = j - 1;
+			}
+		}
+	} else {
+		memcpy(out_reserve(self, n), s, n);
+		self->buf.length += n;
+		if (self->locs)
+			out_track(self, s, n);
+	}
+	if (self->buf.length >= PRINTER_FLUSH && !self->hold)
+		printer_flush(self);
+}
+
+static void outs(Printer *self, const char *s)
+{
+	outn(self, s, strlen(s));
+}
+
+static void outc(Printer *self, char c)
+{
+	outn(self, &c, 1);
+}
+
+static void outf(Printer *self, const char *fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	int n = vsnprintf(NULL, 0, fmt, ap);
+	va_end(ap);
+	if (self->compact) {
+		char tmp[256];
+		char *p = n < (int) sizeof(tmp) ? tmp : malloc(n + 1);
+		va_start(ap, fmt);
+		vsnprintf(p, n + 1, fmt, ap);
+		va_end(ap);
+		outn(self, p, n);
+		if (p != tmp)
+			free(p);
+		return;
+	}
+	char *p = out_reserve(self, n + 1);
+	va_start(ap, fmt);
+	vsnprintf(p, n + 1, fmt, ap);
+	va_end(ap);
+	self->buf.length += n;
+	if (self->locs)
+		out_track(self, p, n);
+	if (self->buf.length >= PRINTER_FLUSH && !self->hold)
+		printer_flush(self);
+}
+
+static void decl_flags_print(Printer *self, unsigned int flags)
 {
 	if (flags & DFLAG_EXTERN)
-		printf("extern ");
+		outs(self, "extern ");
 	if (flags & DFLAG_STATIC)
-		printf("static ");
+		outs(self, "static ");
 	if (flags & DFLAG_REGISTER)
-		printf("register ");
+		outs(self, "register ");
 	if (flags & DFLAG_INLINE)
-		printf("inline ");
+		outs(self, "inline ");
 	if (flags & DFLAG_THREADLOCAL)
-		printf("_Thread_local ");
+		outs(self, "_Thread_local ");
 	if (flags & DFLAG_NORETURN)
-		printf("_Noreturn ");
+		outs(self, "_Noreturn ");
 	if (flags & DFLAG_MANAGED)
-		printf("/* __managed */ ");
+		outs(self, "/* __managed */ ");
 }
 
-static void type_flags_print(Type *t)
+static void type_flags_print(Printer *self, Type *t)
 {
 	unsigned int flags = 0;
 	switch(t->type) {
@@ -47,29 +322,29 @@ static void type_flags_print(Type *t)
 		break;
 	}
 	if (flags & TFLAG_CONST)
-		printf("const ");
+		outs(self, "const ");
 	if (flags & TFLAG_RESTRICT)
-		printf("restrict ");
+		outs(self, "restrict ");
 	if (flags & TFLAG_VOLATILE)
-		printf("volatile ");
+		outs(self, "volatile ");
 	if (flags & TFLAG_ATOMIC)
-		printf("_Atomic ");
+		outs(self, "_Atomic ");
 	if (flags & TFLAG_COMPLEX)
-		printf("_Complex ");
+		outs(self, "_Complex ");
 	if (flags & TFLAG_IMAGINARY)
-		printf("_Imaginary ");
+		outs(self, "_Imaginary ");
 }
 
 static void attrs_print(Printer *self, Attribute *attrs);
 
-static void lp()
+static void lp(Printer *self)
 {
-	printf("(");
+	outs(self, "(");
 }
 
-static void rp()
+static void rp(Printer *self)
 {
-	printf(")");
+	outs(self, ")");
 }
 
 static bool expr_isprim(Expr *h)
@@ -110,13 +385,18 @@ static bool expr_ishigh(Expr *h)
 	return false;
 }
 
+static bool expr_isinit(Expr *h)
+{
+	return h->type == EXPR_INIT || h->type == EXPR_INITPACK;
+}
+
 static void expr_print(Printer *self, Expr *h, bool simple);
 static void expr_print1(Printer *self, Expr *h, bool simple)
 {
-	if (expr_isprim(h) || h->type == EXPR_INIT) {
+	if (expr_isprim(h) || expr_isinit(h)) {
 		expr_print(self, h, simple);
 	} else {
-		lp(); expr_print(self, h, simple); rp();
+		lp(self); expr_print(self, h, simple); rp(self);
 	}
 }
 
@@ -124,7 +404,7 @@ static void expr_print2(Printer *self, Expr *h, bool simple)
 {
 	if (h->type == EXPR_BOP &&
 	    ((ExprBOP *) h)->op == EXPR_OP_COMMA) {
-		lp(); expr_print(self, h, simple); rp();
+		lp(self); expr_print(self, h, simple); rp(self);
 	} else {
 		expr_print(self, h, simple);
 	}
@@ -136,7 +416,7 @@ static void expr_print_assign(Printer *self, Expr *h, bool simple)
 	if (h->type == EXPR_BOP &&
 	    (op == EXPR_OP_COMMA ||
 	     op >= EXPR_OP_ASSIGN && op <= EXPR_OP_ASSIGNBSHR)) {
-		lp(); expr_print(self, h, simple); rp();
+		lp(self); expr_print(self, h, simple); rp(self);
 	} else {
 		expr_print(self, h, simple);
 	}
@@ -144,11 +424,11 @@ static void expr_print_assign(Printer *self, Expr *h, bool simple)
 
 static void expr_print_bop(Printer *self, Expr *h, bool simple)
 {
-	if (expr_isprim(h) || h->type == EXPR_INIT || expr_ishigh(h) ||
+	if (expr_isprim(h) || expr_isinit(h) || expr_ishigh(h) ||
 	    h->type == EXPR_UOP) {
 		expr_print(self, h, simple);
 	} else {
-		lp(); expr_print(self, h, simple); rp();
+		lp(self); expr_print(self, h, simple); rp(self);
 	}
 }
 
@@ -156,25 +436,167 @@ static void expr_print_cond(Printer *self, Expr *h, bool simple)
 {
 	if (h->type == EXPR_BOP &&
 	    ((ExprBOP *) h)->op == EXPR_OP_ASSIGN) {
-		lp(); expr_print(self, h, simple); rp();
+		lp(self); expr_print(self, h, simple); rp(self);
 	} else {
 		expr_print(self, h, simple);
 	}
 }
 
+enum {
+	PREC_COMMA = 1,
+	PREC_ASSIGN,
+	PREC_COND,
+	PREC_OR,
+	PREC_AND,
+	PREC_BOR,
+	PREC_BXOR,
+	PREC_BAND,
+	PREC_EQ,
+	PREC_REL,
+	PREC_SHIFT,
+	PREC_ADD,
+	PREC_MUL,
+	PREC_CAST,
+	PREC_UNARY,
+	PREC_POSTFIX,
+	PREC_PRIMARY,
+};
+
+static const unsigned char bop_prec[] = {
+	[EXPR_OP_ADD] = PREC_ADD,
+	[EXPR_OP_SUB] = PREC_ADD,
+	[EXPR_OP_MUL] = PREC_MUL,
+	[EXPR_OP_DIV] = PREC_MUL,
+	[EXPR_OP_MOD] = PREC_MUL,
+	[EXPR_OP_OR] = PREC_OR,
+	[EXPR_OP_AND] = PREC_AND,
+	[EXPR_OP_BOR] = PREC_BOR,
+	[EXPR_OP_BAND] = PREC_BAND,
+	[EXPR_OP_BXOR] = PREC_BXOR,
+	[EXPR_OP_BSHL] = PREC_SHIFT,
+	[EXPR_OP_BSHR] = PREC_SHIFT,
+	[EXPR_OP_COMMA] = PREC_COMMA,
+	[EXPR_OP_IDX] = PREC_POSTFIX,
+	[EXPR_OP_EQ] = PREC_EQ,
+	[EXPR_OP_NEQ] = PREC_EQ,
+	[EXPR_OP_LT] = PREC_REL,
+	[EXPR_OP_LE] = PREC_REL,
+	[EXPR_OP_GT] = PREC_REL,
+	[EXPR_OP_GE] = PREC_REL,
+	[EXPR_OP_ASSIGN ... EXPR_OP_ASSIGNBSHR] = PREC_ASSIGN,
+};
+
+static bool float_isneg(double v)
+{
+	unsigned long long bits;
+	memcpy(&bits, &v, sizeof(bits));
+	return bits >> 63 && ((bits >> 52) & 0x7ff) != 0x7ff;
+}
+
+/* leading character of h when printed without parentheses, if it
+   could paste with a preceding prefix operator */
+static char expr_lead(Expr *h)
+{
+	switch (h->type) {
+	case EXPR_INT_CST: return ((ExprINT_CST *) h)->v < 0 ? '-' : 0;
+	case EXPR_LONG_CST: return ((ExprLONG_CST *) h)->v < 0 ? '-' : 0;
+	case EXPR_LLONG_CST: return ((ExprLLONG_CST *) h)->v < 0 ? '-' : 0;
+	case EXPR_FLOAT_CST: return float_isneg(((ExprFLOAT_CST *) h)->v) ? '-' : 0;
+	case EXPR_DOUBLE_CST: return float_isneg(((ExprDOUBLE_CST *) h)->v) ? '-' : 0;
+	case EXPR_UOP:
+		switch (((ExprUOP *) h)->op) {
+		case EXPR_OP_NEG: case EXPR_OP_PREDEC: return '-';
+		case EXPR_OP_POS: case EXPR_OP_PREINC: return '+';
+		case EXPR_OP_ADDROF: case EXPR_OP_ADDROFLABEL: return '&';
+		default: return 0;
+		}
+	default: return 0;
+	}
+}
+
+static int expr_prec(Expr *h)
+{
+	switch (h->type) {
+	case EXPR_INT_CST:
+	case EXPR_LONG_CST:
+	case EXPR_LLONG_CST:
+	case EXPR_FLOAT_CST:
+	case EXPR_DOUBLE_CST:
+		return expr_lead(h) ? PREC_UNARY : PREC_PRIMARY;
+	case EXPR_MEM:
+	case EXPR_PMEM:
+	case EXPR_CALL:
+		return PREC_POSTFIX;
+	case EXPR_BOP:
+		return bop_prec[((ExprBOP *) h)->op];
+	case EXPR_UOP: {
+		int op = ((ExprUOP *) h)->op;
+		if (op == EXPR_OP_POSTINC || op == EXPR_OP_POSTDEC)
+			return PREC_POSTFIX;
+		return PREC_UNARY;
+	}
+	case EXPR_COND:
+		return PREC_COND;
+	case EXPR_CAST:
+		if (expr_isinit(((ExprCAST *) h)->e))
+			return PREC_POSTFIX;
+		return PREC_CAST;
+	case EXPR_SIZEOF:
+	case EXPR_SIZEOFT:
+	case EXPR_ALIGNOF:
+		return PREC_UNARY;
+	default:
+		return PREC_PRIMARY;
+	}
+}
+
+static bool expr_needs_parens(Printer *self, Expr *h, int prec,
+			      void (*legacy)(Printer *, Expr *, bool))
+{
+	if (self->minimal_parens)
+		return expr_prec(h) < prec;
+	if (legacy == expr_print1)
+		return !(expr_isprim(h) || expr_isinit(h));
+	return false;
+}
+
+/* operand that must bind at least as tightly as prec; without
+   minimal_parens the legacy heuristic decides */
+static void expr_print_sub(Printer *self, Expr *h, bool simple, int prec,
+			   void (*legacy)(Printer *, Expr *, bool))
+{
+	if (!self->minimal_parens) {
+		legacy(self, h, simple);
+	} else if (expr_prec(h) < prec) {
+		lp(self); expr_print(self, h, simple); rp(self);
+	} else {
+		expr_print(self, h, simple);
+	}
+}
+
+static void expr_print_prefix(Printer *self, const char *op, Expr *h,
+			      bool simple, int prec)
+{
+	outs(self, op);
+	if (!expr_needs_parens(self, h, prec, expr_print1) &&
+	    expr_lead(h) == op[strlen(op) - 1])
+		outc(self, ' ');
+	expr_print_sub(self, h, simple, prec, expr_print1);
+}
+
 static void print_memlist(Printer *self, Expr *h)
 {
 	if (h->type == EXPR_MEM) {
 		ExprMEM *m = (ExprMEM *) h;
 		print_memlist(self, m->a);
-		printf(".%s", m->id);
+		outf(self, ".%s", m->id);
 	} else if (h->type == EXPR_BOP &&
 		   ((ExprBOP *) h)->op == EXPR_OP_IDX) {
 		ExprBOP *i = (ExprBOP *) h;
 		print_memlist(self, i->a);
-		printf("[");
+		outs(self, "[");
 		expr_print(self, i->b, false);
-		printf("]");
+		outs(self, "]");
 	} else {
 		expr_print(self, h, false);
 	}
@@ -183,63 +605,63 @@ static void print_memlist(Printer *self, Expr *h)
 static void stmt_print(Printer *self, Stmt *h, int level);
 static void type_print_annot(Printer *self, Type *type, bool simple)
 {
-	type_flags_print(type);
+	type_flags_print(self, type);
 	switch(type->type) {
 	case TYPE_VOID:
-		printf("void");
+		outs(self, "void");
 		break;
 	case TYPE_PRIM: {
 		switch(((TypePRIM *) type)->kind) {
 		case PT_INT:
-			printf("int");
+			outs(self, "int");
 			break;
 		case PT_SHORT:
-			printf("short");
+			outs(self, "short");
 			break;
 		case PT_LONG:
-			printf("long");
+			outs(self, "long");
 			break;
 		case PT_LLONG:
-			printf("long long");
+			outs(self, "long long");
 			break;
 		case PT_UINT:
-			printf("unsigned int");
+			outs(self, "unsigned int");
 			break;
 		case PT_USHORT:
-			printf("unsigned short");
+			outs(self, "unsigned short");
 			break;
 		case PT_ULONG:
-			printf("unsigned long");
+			outs(self, "unsigned long");
 			break;
 		case PT_ULLONG:
-			printf("unsigned long long");
+			outs(self, "unsigned long long");
 			break;
 		case PT_BOOL:
-			printf("_Bool");
+			outs(self, "_Bool");
 			break;
 		case PT_FLOAT:
-			printf("float");
+			outs(self, "float");
 			break;
 		case PT_LDOUBLE:
-			printf("long double");
+			outs(self, "long double");
 			break;
 		case PT_DOUBLE:
-			printf("double");
+			outs(self, "double");
 			break;
 		case PT_CHAR:
-			printf("char");
+			outs(self, "char");
 			break;
 		case PT_SCHAR:
-			printf("signed char");
+			outs(self, "signed char");
 			break;
 		case PT_UCHAR:
-			printf("unsigned char");
+			outs(self, "unsigned char");
 			break;
 		case PT_INT128:
-			printf("__int128");
+			outs(self, "__int128");
 			break;
 		case PT_UINT128:
-			printf("unsigned __int128");
+			outs(self, "unsigned __int128");
 			break;
 		default:
 			abort();
@@ -247,52 +669,52 @@ static void type_print_annot(Printer *self, Type *type, bool simple)
 		break;
 	}
 	case TYPE_PTR:
-		printf("pointer(");
+		outs(self, "pointer(");
 		type_print_annot(self, ((TypePTR *) type)->t, simple);
-		printf(")");
+		outs(self, ")");
 		break;
 	case TYPE_ARRAY:
-		printf("array(");
+		outs(self, "array(");
 		type_print_annot(self, ((TypeARRAY *) type)->t, simple);
-		printf(", ");
+		outs(self, ", ");
 		if (((TypeARRAY *) type)->n) {
 			if (((TypeARRAY *) type)->flags & TFLAG_ARRAY_STATIC)
-				printf("static ");
+				outs(self, "static ");
 			expr_print2(self, ((TypeARRAY *) type)->n, simple);
 		}
-		printf(")");
+		outs(self, ")");
 		break;
 	case TYPE_FUN:
-		printf("(");
+		outs(self, "(");
 		Type *p;
 		int i;
 		bool flag = false;
 		avec_foreach(&((TypeFUN *) type)->at, p, i) {
-			if (i) printf(", ");
+			if (i) outs(self, ", ");
 			type_print_annot(self, p, simple);
 			flag = true;
 		}
 		if (((TypeFUN *) type)->va_arg)
-			printf("%s...", flag ? ", " : "");
-		printf(") -> ");
+			outf(self, "%s...", flag ? ", " : "");
+		outs(self, ") -> ");
 		type_print_annot(self, ((TypeFUN *) type)->rt, simple);
 		break;
 	case TYPE_TYPEDEF:
-		printf("%s", ((TypeTYPEDEF *) type)->name);
+		outs(self, ((TypeTYPEDEF *) type)->name);
 		break;
 	case TYPE_STRUCT: {
 		TypeSTRUCT *t = (TypeSTRUCT *) type;
-		printf("%s", t->is_union ? "union" : "struct");
+		outs(self, t->is_union ? "union" : "struct");
 		if (t->attrs) {
-			printf(" ");
+			outs(self, " ");
 			attrs_print(self, t->attrs);
 		}
-		if (t->tag) printf(" %s", t->tag);
+		if (t->tag) outf(self, " %s", t->tag);
 		if (t->decls) {
 			if (simple) {
-				printf(" {/* ... */}");
+				outs(self, " {/* ... */}");
 			} else {
-				printf(" ");
+				outs(self, " ");
 				stmt_print(self, (Stmt *) t->decls, 0);
 			}
 		}
@@ -300,54 +722,54 @@ static void type_print_annot(Printer *self, Type *type, bool simple)
 	}
 	case TYPE_ENUM: {
 		TypeENUM *t = (TypeENUM *) type;
-		printf("enum");
+		outs(self, "enum");
 		if (t->attrs) {
-			printf(" ");
+			outs(self, " ");
 			attrs_print(self, t->attrs);
 		}
-		if (t->tag) printf(" %s", t->tag);
+		if (t->tag) outf(self, " %s", t->tag);
 		if (t->list) {
 			if (simple) {
-				printf(" {/* ... */}");
+				outs(self, " {/* ... */}");
 			} else {
-				printf(" {\n");
+				outs(self, " {\n");
 				struct EnumPair_ *p;
 				int i;
 				avec_foreach_ptr(&(t->list->items), p, i) {
-					printf("\t%s", p->id);
+					outf(self, "\t%s", p->id);
 					if (p->attr) {
-						printf(" ");
+						outs(self, " ");
 						attrs_print(self, p->attr);
 					}
 					if (p->val) {
-						printf(" = ");
-						expr_print1(self, p->val, simple);
-						printf(",\n");
+						outs(self, " = ");
+						expr_print_sub(self, p->val, simple, PREC_COND, expr_print1);
+						outs(self, ",\n");
 					} else {
-						printf(",\n");
+						outs(self, ",\n");
 					}
 				}
-				printf("}");
+				outs(self, "}");
 			}
 		}
 		break;
 	}
 	case TYPE_TYPEOF: {
 		TypeTYPEOF *t = (TypeTYPEOF *) type;
-		printf("__typeof__(");
+		outs(self, "__typeof__(");
 		expr_print(self, t->e, simple);
-		printf(")");
+		outs(self, ")");
 		break;
 	}
 	case TYPE_TYPEOFUNQUAL: {
 		TypeTYPEOFUNQUAL *t = (TypeTYPEOFUNQUAL *) type;
-		printf("__typeof_unqual__(");
+		outs(self, "__typeof_unqual__(");
 		expr_print(self, t->e, simple);
-		printf(")");
+		outs(self, ")");
 		break;
 	}
 	case TYPE_AUTO:
-		printf("__auto_type");
+		outs(self, "__auto_type");
 		break;
 	default:
 		assert(false);
@@ -379,17 +801,17 @@ static void type_print_declarator1(Printer *self, Type *type)
 		Type *nt = ((TypePTR *) type)->t;
 		type_print_declarator1(self, nt);
 		if (nt->type == TYPE_FUN || nt->type == TYPE_PTR || nt->type == TYPE_ARRAY)
-			printf("(*");
+			outs(self, "(*");
 		else
-			printf("*");
-		type_flags_print(type);
+			outs(self, "*");
+		type_flags_print(self, type);
 		return;
 	}
 	case TYPE_ARRAY: {
 		Type *nt = ((TypeARRAY *) type)->t;
 		type_print_declarator1(self, ((TypeARRAY *) type)->t);
 		if (nt->type == TYPE_FUN || nt->type == TYPE_PTR || nt->type == TYPE_ARRAY)
-			printf("(");
+			outs(self, "(");
 		return;
 	}
 	default:
@@ -403,47 +825,48 @@ static void type_print_declarator2(Printer *self, Type *type)
 {
 	switch(type->type) {
 	case TYPE_FUN:
-		printf("(");
+		outs(self, "(");
 		Type *p;
 		int i;
 		avec_foreach(&((TypeFUN *) type)->at, p, i) {
-			if (i) printf(", ");
+			if (i) outs(self, ", ");
 			type_print_annot(self, type_get_basic(p), false);
-			printf(" ");
+			outs(self, " ");
 			type_print_declarator1(self, p);
 			type_print_declarator2(self, p);
 		}
 		TypeFUN *tf = (TypeFUN *) type;
 		if (tf->at.length == 0) {
 			if (!tf->va_arg)
-				printf("void");
+				outs(self, "void");
 		} else {
 			if (tf->va_arg)
-				printf(", ...");
+				outs(self, ", ...");
 		}
-		printf(")");
+		outs(self, ")");
 		type_print_declarator2(self, ((TypeFUN *) type)->rt);
 		return;
 	case TYPE_PTR: {
 		Type *nt = ((TypePTR *) type)->t;
 		if (nt->type == TYPE_FUN || nt->type == TYPE_PTR || nt->type == TYPE_ARRAY)
-			printf(")");
+			outs(self, ")");
 		type_print_declarator2(self, nt);
 		return;
 	}
 	case TYPE_ARRAY: {
 		Type *nt = ((TypeARRAY *) type)->t;
-		printf("[");
-		type_flags_print(type);
+		outs(self, "[");
+		type_flags_print(self, type);
 		if (((TypeARRAY *) type)->n) {
 			if (((TypeARRAY *) type)->flags & TFLAG_ARRAY_STATIC)
-				printf("static ");
-			expr_print1(self, ((TypeARRAY *) type)->n, false);
+				outs(self, "static ");
+			expr_print_sub(self, ((TypeARRAY *) type)->n, false,
+				       PREC_ASSIGN, expr_print1);
 		}
 		if (nt->type == TYPE_FUN || nt->type == TYPE_PTR || nt->type == TYPE_ARRAY)
-			printf("])");
+			outs(self, "])");
 		else
-			printf("]");
+			outs(self, "]");
 		type_print_declarator2(self, nt);
 		return;
 	}
@@ -458,14 +881,14 @@ static void type_print_vardecl(Printer *self, unsigned int flags, Type *type, co
 		type_print_annot(self, type, true);
 		return;
 	}
-	decl_flags_print(flags);
+	decl_flags_print(self, flags);
 	type_print_annot(self, type_get_basic(type), false);
-	printf(" ");
+	outs(self, " ");
 	type_print_declarator1(self, type);
 	if (name) {
-		printf("%s", name);
+		outs(self, name);
 	} else {
-		printf("/* unnamed */");
+		outs(self, "/* unnamed */");
 	}
 	type_print_declarator2(self, type);
 }
@@ -481,40 +904,40 @@ static void type_print_fundecl(Printer *self, unsigned int flags, TypeFUN *type,
 	  (3)    __attribute__((...)) int a, b; // a and b have attr
 	*/
 
-	decl_flags_print(flags);
+	decl_flags_print(self, flags);
 	// safe, because we don't declare multiple variables in one line
 	if (attrs) {
 		attrs_print(self, attrs);
-		printf(" ");
+		outs(self, " ");
 	}
 	type_print_annot(self, type_get_basic(rt), false);
-	printf(" ");
+	outs(self, " ");
 	type_print_declarator1(self, rt);
-	printf("%s(", name);
+	outf(self, "%s(", name);
 	if (args) {
 		Stmt *p;
 		int i;
 		avec_foreach(&args->items, p, i) {
 			StmtVARDECL *p1 = (StmtVARDECL *) p;
 			if (i)
-				printf(", ");
+				outs(self, ", ");
 			type_print_vardecl(self,
 				p1->flags,
 				p1->type,
 				p1->name,
 				false);
 			if (p1->ext.gcc_attribute) {
-				printf(" ");
+				outs(self, " ");
 				attrs_print(self, p1->ext.gcc_attribute);
 			}
 		}
 		if (type->va_arg)
-			printf(", ...");
+			outs(self, ", ...");
 	} else {
 		if (!type->va_arg)
-			printf("void");
+			outs(self, "void");
 	}
-	printf(")");
+	outs(self, ")");
 	type_print_declarator2(self, rt);
 }
 
@@ -560,27 +983,429 @@ static const char *bopname(ExprBinOp op)
 	}
 }
 
-static void print_quoted(const char *v, int len)
+/* 0: copied verbatim, 1: quote_escapes[], 2: hex escape */
+static const unsigned char quote_class[256] = {
+	2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 2, 1, 1, 2, 2,
+	2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+	0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+};
+
+static const char *const quote_escapes[128] = {
+	['\\'] = "\\\\", ['"'] = "\\\"", ['?'] = "\\?",
+	['\a'] = "\\a", ['\b'] = "\\b", ['\f'] = "\\f",
+	['\n'] = "\\n", ['\r'] = "\\r", ['\t'] = "\\t",
+};
+
+static void print_quoted(Printer *self, const char *v, int len)
 {
-	for (int i = 0; i < len; i++) {
-		switch(v[i]) {
-		case '\\': printf("\\\\"); break;
-		case '\"': printf("\\\""); break;
-		case '\a': printf("\\a"); break;
-		case '\b': printf("\\b"); break;
-		case '\f': printf("\\f"); break;
-		case '\n': printf("\\n"); break;
-		case '\r': printf("\\r"); break;
-		case '\t': printf("\\t"); break;
-		case '?': printf("\\\?"); break;
-		default:
-			if (v[i] >= 0 && v[i] < 32) {
-				printf("\"\"\\x%x\"\"", v[i]); break;
-			} else {
-				putchar(v[i]); break;
+	const unsigned char *s = (const unsigned char *) v;
+	int i = 0;
+	while (i < len) {
+		int start = i;
+		while (i < len && !quote_class[s[i]])
+			i++;
+		if (i > start)
+			outn(self, v + start, i - start);
+		if (i == len)
+			break;
+		if (quote_class[s[i]] == 1)
+			outn(self, quote_escapes[s[i]], 2);
+		else
+			outf(self, "\"\"\\x%x\"\"", s[i]);
+		i++;
+	}
+}
+
+#include "printer-ryu.inc"
+
+static int pow5_factor(unsigned long long v)
+{
+	int n = 0;
+	while (v % 5 == 0) {
+		v /= 5;
+		n++;
+	}
+	return n;
+}
+
+static int pow5bits(int e)
+{
+	return ((e * 1217359) >> 19) + 1;
+}
+
+static int log10_pow2(int e)
+{
+	return (e * 78913) >> 18;
+}
+
+static int log10_pow5(int e)
+{
+	return (e * 732923) >> 20;
+}
+
+static unsigned long long mul_shift64(unsigned long long m,
+				      const unsigned long long *mul, int j)
+{
+	unsigned __int128 b0 = (unsigned __int128) m * mul[0];
+	unsigned __int128 b2 = (unsigned __int128) m * mul[1];
+	return (unsigned long long) (((b0 >> 64) + b2) >> (j - 64));
+}
+
+static unsigned int mul_shift32(unsigned int m, unsigned long long factor,
+				int shift)
+{
+	unsigned long long bits0 = (unsigned long long) m * (unsigned int) factor;
+	unsigned long long bits1 = (unsigned long long) m * (factor >> 32);
+	return ((bits0 >> 32) + bits1) >> (shift - 32);
+}
+
+/* Ryu: shortest decimal digits and exponent that round-trip.
+   mbits is 52 or 23; m2/e2 are the unbiased mantissa and exponent
+   scaled by 4 as in the paper; float formats use the upper halves
+   of the double tables. */
+static unsigned long long ryu(int mbits, unsigned long long ieee_m,
+			      int ieee_e, int bias, int *exp)
+{
+	unsigned long long m2;
+	int e2;
+	if (ieee_e == 0) {
+		e2 = 1 - bias - mbits - 2;
+		m2 = ieee_m;
+	} else {
+		e2 = ieee_e - bias - mbits - 2;
+		m2 = (1ull << mbits) | ieee_m;
+	}
+	bool even = (m2 & 1) == 0;
+	bool accept_bounds = even;
+
+	unsigned long long mv = 4 * m2;
+	int mm_shift = ieee_m != 0 || ieee_e <= 1;
+	unsigned long long mp = mv + 2, mm = mv - 1 - mm_shift;
+
+	unsigned long long vr, vp, vm;
+	int e10;
+	bool vm_tz = false, vr_tz = false;
+	int last = 0;
+	if (mbits == 52) {
+		if (e2 >= 0) {
+			int q = log10_pow2(e2) - (e2 > 3);
+			e10 = q;
+			int k = 125 + pow5bits(q) - 1;
+			int i = -e2 + q + k;
+			vr = mul_shift64(mv, double_pow5_inv_split[q], i);
+			vp = mul_shift64(mp, double_pow5_inv_split[q], i);
+			vm = mul_shift64(mm, double_pow5_inv_split[q], i);
+			if (q <= 21) {
+				if (mv % 5 == 0)
+					vr_tz = pow5_factor(mv) >= q;
+				else if (accept_bounds)
+					vm_tz = pow5_factor(mm) >= q;
+				else
+					vp -= pow5_factor(mp) >= q;
+			}
+		} else {
+			int q = log10_pow5(-e2) - (-e2 > 1);
+			e10 = q + e2;
+			int i = -e2 - q;
+			int k = pow5bits(i) - 125;
+			int j = q - k;
+			vr = mul_shift64(mv, double_pow5_split[i], j);
+			vp = mul_shift64(mp, double_pow5_split[i], j);
+			vm = mul_shift64(mm, double_pow5_split[i], j);
+			if (q <= 1) {
+				vr_tz = true;
+				if (accept_bounds)
+					vm_tz = mm_shift == 1;
+				else
+					vp--;
+			} else if (q < 63) {
+				vr_tz = (mv & ((1ull << q) - 1)) == 0;
+			}
+		}
+	} else {
+		if (e2 >= 0) {
+			int q = log10_pow2(e2);
+			e10 = q;
+			int k = 61 + pow5bits(q) - 1;
+			int i = -e2 + q + k;
+			unsigned long long f = double_pow5_inv_split[q][1] + 1;
+			vr = mul_shift32(mv, f, i);
+			vp = mul_shift32(mp, f, i);
+			vm = mul_shift32(mm, f, i);
+			if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+				int l = 61 + pow5bits(q - 1) - 1;
+				last = mul_shift32(mv, double_pow5_inv_split[q - 1][1] + 1,
+						   -e2 + q - 1 + l) % 10;
+			}
+			if (q <= 9) {
+				if (mv % 5 == 0)
+					vr_tz = pow5_factor(mv) >= q;
+				else if (accept_bounds)
+					vm_tz = pow5_factor(mm) >= q;
+				else
+					vp -= pow5_factor(mp) >= q;
+			}
+		} else {
+			int q = log10_pow5(-e2);
+			e10 = q + e2;
+			int i = -e2 - q;
+			int k = pow5bits(i) - 61;
+			int j = q - k;
+			unsigned long long f = double_pow5_split[i][1];
+			vr = mul_shift32(mv, f, j);
+			vp = mul_shift32(mp, f, j);
+			vm = mul_shift32(mm, f, j);
+			if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+				j = q - 1 - (pow5bits(i + 1) - 61);
+				last = mul_shift32(mv, double_pow5_split[i + 1][1], j) % 10;
 			}
+			if (q <= 1) {
+				vr_tz = true;
+				if (accept_bounds)
+					vm_tz = mm_shift == 1;
+				else
+					vp--;
+			} else if (q < 31) {
+				vr_tz = (mv & ((1ull << (q - 1)) - 1)) == 0;
+			}
+		}
+	}
+
+	int removed = 0;
+	unsigned long long output;
+	if (vm_tz || vr_tz) {
+		while (vp / 10 > vm / 10) {
+			vm_tz &= vm % 10 == 0;
+			vr_tz &= last == 0;
+			last = vr % 10;
+			vr /= 10; vp /= 10; vm /= 10;
+			removed++;
+		}
+		if (vm_tz) {
+			while (vm % 10 == 0) {
+				vr_tz &= last == 0;
+				last = vr % 10;
+				vr /= 10; vp /= 10; vm /= 10;
+				removed++;
+			}
+		}
+		if (vr_tz && last == 5 && vr % 2 == 0)
+			last = 4;
+		output = vr + ((vr == vm && (!accept_bounds || !vm_tz)) || last >= 5);
+	} else {
+		bool round_up = last >= 5;
+		while (vp / 10 > vm / 10) {
+			round_up = vr % 10 >= 5;
+			vr /= 10; vp /= 10; vm /= 10;
+			removed++;
+		}
+		output = vr + (vr == vm || round_up);
+	}
+	*exp = e10 + removed;
+	return output;
+}
+
+static int dec_width(int v)
+{
+	int n = v < 0 ? 2 : 1;
+	for (v = v < 0 ? -v : v; v >= 10; v /= 10)
+		n++;
+	return n;
+}
+
+/* digits * 10^exp as the shorter of the fixed and scientific forms */
+static int format_decimal(char *buf, unsigned long long digits, int exp)
+{
+	char d[24];
+	int n = 0;
+	do {
+		d[n++] = '0' + digits % 10;
+		digits /= 10;
+	} while (digits);
+
+	int point = n + exp;	// position of the decimal point
+	int fixed = exp >= 0 ? n + exp + 2 : point > 0 ? n + 1 : n + 2 - point;
+	int sci = n + 1 + (n == 1) + 1 + dec_width(point - 1);
+
+	int len = 0;
+	if (fixed <= sci && exp >= 0) {
+		while (n)
+			buf[len++] = d[--n];
+		for (int i = 0; i < exp; i++)
+			buf[len++] = '0';
+		buf[len++] = '.';
+		buf[len++] = '0';
+	} else if (fixed <= sci && point > 0) {
+		for (int i = 0; i < point; i++)
+			buf[len++] = d[--n];
+		buf[len++] = '.';
+		while (n)
+			buf[len++] = d[--n];
+	} else if (fixed <= sci) {
+		buf[len++] = '0';
+		buf[len++] = '.';
+		for (int i = 0; i < -point; i++)
+			buf[len++] = '0';
+		while (n)
+			buf[len++] = d[--n];
+	} else {
+		buf[len++] = d[--n];
+		buf[len++] = '.';
+		if (n == 0)
+			buf[len++] = '0';
+		while (n)
+			buf[len++] = d[--n];
+		len += sprintf(buf + len, "e%d", point - 1);
+	}
+	buf[len] = 0;
+	return len;
+}
+
+static void double_print(Printer *self, double v)
+{
+	unsigned long long bits;
+	memcpy(&bits, &v, sizeof(bits));
+	unsigned long long m = bits & ((1ull << 52) - 1);
+	int e = (bits >> 52) & 0x7ff;
+	if (e == 0x7ff) {
+		if (m)
+			outs(self, "(__builtin_nan(\"\"))");
+		else
+			outs(self, bits >> 63 ? "(-__builtin_inf())" : "(__builtin_inf())");
+	} else if (e == 0 && m) {
+		outf(self, "%a", v);
+	} else {
+		char buf[40];
+		int exp = 0;
+		unsigned long long digits = e || m ? ryu(52, m, e, 1023, &exp) : 0;
+		if (bits >> 63)
+			outc(self, '-');
+		format_decimal(buf, digits, exp);
+		outs(self, buf);
+	}
+}
+
+static void float_print(Printer *self, float v)
+{
+	unsigned int bits;
+	memcpy(&bits, &v, sizeof(bits));
+	unsigned int m = bits & ((1u << 23) - 1);
+	int e = (bits >> 23) & 0xff;
+	if (e == 0xff) {
+		if (m)
+			outs(self, "(__builtin_nanf(\"\"))");
+		else
+			outs(self, bits >> 31 ? "(-__builtin_inff())" : "(__builtin_inff())");
+	} else if (e == 0 && m) {
+		outf(self, "%af", v);
+	} else {
+		char buf[40];
+		int exp = 0;
+		unsigned long long digits = e || m ? ryu(23, m, e, 127, &exp) : 0;
+		if (bits >> 31)
+			outc(self, '-');
+		format_decimal(buf, digits, exp);
+		outf(self, "%sf", buf);
+	}
+}
+
+static bool expr_is_chain(Expr *h)
+{
+	if (h->type != EXPR_BOP)
+		return false;
+	int op = ((ExprBOP *) h)->op;
+	return op != EXPR_OP_IDX && bop_prec[op] != PREC_ASSIGN;
+}
+
+// whether e's left operand, a chain itself, goes in parentheses
+static bool expr_chain_parens(Printer *self, ExprBOP *e)
+{
+	if (!self->minimal_parens)
+		return true;
+	return expr_prec(e->a) < bop_prec[e->op];
+}
+
+/* a + b + c + ... nests to the left: walk down the left operands
+   first, then print the operators on the way back up */
+static void expr_print_chain(Printer *self, ExprBOP *e, bool simple)
+{
+	int base = self->spine.length;
+	vec_push(&self->spine, e);
+	while (expr_is_chain(e->a)) {
+		if (expr_chain_parens(self, e))
+			lp(self);
+		e = (ExprBOP *) e->a;
+		vec_push(&self->spine, e);
+	}
+	expr_print_sub(self, e->a, simple, bop_prec[e->op], expr_print_bop);
+	while (self->spine.length > base) {
+		e = vec_pop(&self->spine);
+		if (e->op == EXPR_OP_COMMA)
+			outs(self, ", ");
+		else
+			outf(self, " %s ", bopname(e->op));
+		expr_print_sub(self, e->b, simple, bop_prec[e->op] + 1,
+			       expr_print_bop);
+		if (self->spine.length > base &&
+		    expr_chain_parens(self, vec_last(&self->spine)))
+			rp(self);
+	}
+}
+
+// text of only digits, signs, suffixes and commas; nothing to compact
+static void out_numbers(Printer *self, const char *s, int n)
+{
+	if (!self->compact || !n) {
+		outn(self, s, n);
+		return;
+	}
+	memcpy(out_reserve(self, n), s, n);
+	self->buf.length += n;
+	self->clast = s[n - 1];
+	self->cspace = false;
+	self->cnumber = is_idchar(self->clast);
+	if (self->buf.length >= PRINTER_FLUSH && !self->hold)
+		printer_flush(self);
+}
+
+// as EXPR_INIT of the constants, formatted a chunk at a time
+static void initpack_print(Printer *self, ExprINITPACK *e)
+{
+	const char *sep = self->compact ? "," : ",\n\t";
+	int seplen = strlen(sep);
+	char buf[4096 + 32];
+	int n = 0;
+	outs(self, "{\n");
+	if (!self->compact)
+		buf[n++] = '\t';
+	for (int i = 0; i < e->length; i++) {
+		if (i) {
+			memcpy(buf + n, sep, seplen);
+			n += seplen;
+		}
+		long long v = exprINITPACK_get(e, i);
+		char digits[24];
+		int k = 0;
+		unsigned long long u = v < 0 ? -(unsigned long long) v : v;
+		do
+			digits[k++] = '0' + u % 10;
+		while ((u /= 10));
+		if (v < 0)
+			buf[n++] = '-';
+		while (k)
+			buf[n++] = digits[--k];
+		if (e->kind == EXPR_UINT_CST)
+			buf[n++] = 'u';
+		if (n >= 4096) {
+			out_numbers(self, buf, n);
+			n = 0;
 		}
 	}
+	out_numbers(self, buf, n);
+	outs(self, "\n}");
 }
 
 static void expr_print(Printer *self, Expr *h, bool simple)
@@ -588,345 +1413,359 @@ static void expr_print(Printer *self, Expr *h, bool simple)
 	switch (h->type) {
 	case EXPR_INT_CST: {
 		ExprINT_CST *e = (ExprINT_CST *) h;
-		printf("%d", e->v);
+		outf(self, "%d", e->v);
 		break;
 	}
 	case EXPR_UINT_CST: {
 		ExprUINT_CST *e = (ExprUINT_CST *) h;
-		printf("%uu", e->v);
+		outf(self, "%uu", e->v);
 		break;
 	}
 	case EXPR_LONG_CST: {
 		ExprLONG_CST *e = (ExprLONG_CST *) h;
-		printf("%ldl", e->v);
+		outf(self, "%ldl", e->v);
 		break;
 	}
 	case EXPR_ULONG_CST: {
 		ExprULONG_CST *e = (ExprULONG_CST *) h;
-		printf("%luul", e->v);
+		outf(self, "%luul", e->v);
 		break;
 	}
 	case EXPR_LLONG_CST: {
 		ExprLLONG_CST *e = (ExprLLONG_CST *) h;
-		printf("%lldll", e->v);
+		outf(self, "%lldll", e->v);
 		break;
 	}
 	case EXPR_ULLONG_CST: {
 		ExprULLONG_CST *e = (ExprULLONG_CST *) h;
-		printf("%lluull", e->v);
+		outf(self, "%lluull", e->v);
 		break;
 	}
 	case EXPR_CHAR_CST: {
 		ExprCHAR_CST *e = (ExprCHAR_CST *) h;
 		switch(e->kind) {
 		case WCK_NONE: break;
-		case WCK_L: putchar('L'); break;
-		case WCK_u: putchar('u'); break;
-		case WCK_U: putchar('U'); break;
-		case WCK_u8: printf("u8"); break;
+		case WCK_L: outc(self, 'L'); break;
+		case WCK_u: outc(self, 'u'); break;
+		case WCK_U: outc(self, 'U'); break;
+		case WCK_u8: outs(self, "u8"); break;
 		}
-		putchar('\'');
+		outc(self, '\'');
 		switch(e->v) {
-		case '\\': printf("\\\\"); break;
-		case '\'': printf("\\\'"); break;
-		case '\a': printf("\\a"); break;
-		case '\b': printf("\\b"); break;
-		case '\f': printf("\\f"); break;
-		case '\n': printf("\\n"); break;
-		case '\r': printf("\\r"); break;
-		case '\t': printf("\\t"); break;
-		case '\0': printf("\\0"); break;
+		case '\\': outs(self, "\\\\"); break;
+		case '\'': outs(self, "\\\'"); break;
+		case '\a': outs(self, "\\a"); break;
+		case '\b': outs(self, "\\b"); break;
+		case '\f': outs(self, "\\f"); break;
+		case '\n': outs(self, "\\n"); break;
+		case '\r': outs(self, "\\r"); break;
+		case '\t': outs(self, "\\t"); break;
+		case '\0': outs(self, "\\0"); break;
 		default:
 			if (e->v >= 0 && e->v < 32) {
-				printf("\\x%x", e->v); break;
+				outf(self, "\\x%x", e->v); break;
 			} else {
-				putchar(e->v); break;
+				outc(self, e->v); break;
 			}
 		}
-		putchar('\'');
+		outc(self, '\'');
 		break;
 	}
 	case EXPR_STRING_CST: {
 		ExprSTRING_CST *e = (ExprSTRING_CST *) h;
 		switch(e->kind) {
 		case WCK_NONE: break;
-		case WCK_L: putchar('L'); break;
-		case WCK_u: putchar('u'); break;
-		case WCK_U: putchar('U'); break;
-		case WCK_u8: printf("u8"); break;
+		case WCK_L: outc(self, 'L'); break;
+		case WCK_u: outc(self, 'u'); break;
+		case WCK_U: outc(self, 'U'); break;
+		case WCK_u8: outs(self, "u8"); break;
 		}
-		putchar('"');
-		print_quoted(e->v, e->len - 1);
-		putchar('"');
+		outc(self, '"');
+		print_quoted(self, e->v, e->len - 1);
+		outc(self, '"');
 		break;
 	}
 	case EXPR_BOOL_CST: {
 		ExprBOOL_CST *e = (ExprBOOL_CST *) h;
-		printf("%s", e->v ? "true" : "false");
+		outs(self, e->v ? "true" : "false");
 		break;
 	}
 	case EXPR_FLOAT_CST: {
 		ExprFLOAT_CST *e = (ExprFLOAT_CST *) h;
-		if (isinf(e->v)) {
-			printf("(__builtin_inff())");
-		} else {
-			printf("%.20ef", e->v);
-		}
+		float_print(self, e->v);
 		break;
 	}
 	case EXPR_DOUBLE_CST: {
 		ExprDOUBLE_CST *e = (ExprDOUBLE_CST *) h;
-		if (isinf(e->v)) {
-			printf("(__builtin_inf())");
-		} else {
-			printf("%.20e", e->v);
-		}
+		double_print(self, e->v);
 		break;
 	}
 	case EXPR_IDENT: {
 		ExprIDENT *e = (ExprIDENT *) h;
-		printf("%s", e->id);
+		outs(self, e->id);
 		break;
 	}
 	case EXPR_MEM: {
 		ExprMEM *e = (ExprMEM *) h;
-		expr_print1(self, e->a, simple);
-		printf(".%s", e->id);
+		expr_print_sub(self, e->a, simple, PREC_POSTFIX, expr_print1);
+		outf(self, ".%s", e->id);
 		break;
 	}
 	case EXPR_PMEM: {
 		ExprPMEM *e = (ExprPMEM *) h;
-		expr_print1(self, e->a, simple);
-		printf("->%s", e->id);
+		expr_print_sub(self, e->a, simple, PREC_POSTFIX, expr_print1);
+		outf(self, "->%s", e->id);
 		break;
 	}
 	case EXPR_CALL: {
 		ExprCALL *e = (ExprCALL *) h;
-		expr_print1(self, e->func, simple);
-		printf("(");
+		expr_print_sub(self, e->func, simple, PREC_POSTFIX, expr_print1);
+		outs(self, "(");
 		Expr *p;
 		int i;
 		avec_foreach(&e->args, p, i) {
-			if (i) printf(", ");
-			expr_print2(self, p, simple);
+			if (i) outs(self, ", ");
+			expr_print_sub(self, p, simple, PREC_ASSIGN, expr_print2);
 		}
-		printf(")");
+		outs(self, ")");
 		break;
 	}
 	case EXPR_BOP: {
 		ExprBOP *e = (ExprBOP *) h;
+		int prec = bop_prec[e->op];
 		if (e->op == EXPR_OP_IDX) {
-			expr_print1(self, e->a, simple);
-			printf("["); expr_print(self, e->b, simple); printf("]");
-		} else if (e->op >= EXPR_OP_ASSIGN && e->op <= EXPR_OP_ASSIGNBSHR) {
-			expr_print_assign(self, e->a, simple);
-			printf(" %s ", bopname(e->op));
-			expr_print_assign(self, e->b, simple);
+			expr_print_sub(self, e->a, simple, PREC_POSTFIX, expr_print1);
+			outs(self, "["); expr_print(self, e->b, simple); outs(self, "]");
+		} else if (prec == PREC_ASSIGN) {
+			expr_print_sub(self, e->a, simple, PREC_UNARY, expr_print_assign);
+			outf(self, " %s ", bopname(e->op));
+			expr_print_sub(self, e->b, simple, PREC_ASSIGN, expr_print_assign);
 		} else {
-			expr_print_bop(self, e->a, simple);
-			if (e->op == EXPR_OP_COMMA)
-				printf(", ");
-			else
-				printf(" %s ", bopname(e->op));
-			expr_print_bop(self, e->b, simple);
+			expr_print_chain(self, e, simple);
 		}
 		break;
 	}
 	case EXPR_UOP: {
 		ExprUOP *e = (ExprUOP *) h;
 		switch (e->op) {
-		case EXPR_OP_NEG: printf("-"); expr_print1(self, e->e, simple); break;
-		case EXPR_OP_POS: printf("+"); expr_print1(self, e->e, simple); break;
-		case EXPR_OP_NOT: printf("!"); expr_print1(self, e->e, simple); break;
-		case EXPR_OP_BNOT: printf("~"); expr_print1(self, e->e, simple); break;
+		case EXPR_OP_NEG: expr_print_prefix(self, "-", e->e, simple, PREC_CAST); break;
+		case EXPR_OP_POS: expr_print_prefix(self, "+", e->e, simple, PREC_CAST); break;
+		case EXPR_OP_NOT: expr_print_prefix(self, "!", e->e, simple, PREC_CAST); break;
+		case EXPR_OP_BNOT: expr_print_prefix(self, "~", e->e, simple, PREC_CAST); break;
 
-		case EXPR_OP_ADDROF: printf("&"); expr_print1(self, e->e, simple); break;
-		case EXPR_OP_DEREF: printf("*"); expr_print1(self, e->e, simple); break;
+		case EXPR_OP_ADDROF: expr_print_prefix(self, "&", e->e, simple, PREC_CAST); break;
+		case EXPR_OP_DEREF: expr_print_prefix(self, "*", e->e, simple, PREC_CAST); break;
 
-		case EXPR_OP_PREINC: printf("++"); expr_print1(self, e->e, simple); break;
-		case EXPR_OP_POSTINC: expr_print1(self, e->e, simple); printf("++"); break;
-		case EXPR_OP_PREDEC: printf("--"); expr_print1(self, e->e, simple); break;
-		case EXPR_OP_POSTDEC: expr_print1(self, e->e, simple); printf("--"); break;
+		case EXPR_OP_PREINC: expr_print_prefix(self, "++", e->e, simple, PREC_UNARY); break;
+		case EXPR_OP_POSTINC:
+			expr_print_sub(self, e->e, simple, PREC_POSTFIX, expr_print1);
+			outs(self, "++");
+			break;
+		case EXPR_OP_PREDEC: expr_print_prefix(self, "--", e->e, simple, PREC_UNARY); break;
+		case EXPR_OP_POSTDEC:
+			expr_print_sub(self, e->e, simple, PREC_POSTFIX, expr_print1);
+			outs(self, "--");
+			break;
 
 		case EXPR_OP_ADDROFLABEL:
-			printf("&&%s", ((ExprIDENT * )e->e)->id); break;
+			outf(self, "&&%s", ((ExprIDENT * )e->e)->id); break;
 		default: abort();
 		}
 		break;
 	}
 	case EXPR_COND: {
 		ExprCOND *e = (ExprCOND *) h;
-		expr_print1(self, e->c, simple);
-		printf(" ? ");
-		if (e->a)
-			expr_print1(self, e->a, simple);
-		printf(" : ");
-		expr_print1(self, e->b, simple);
+		int nested = 0;
+		// conditionals nest to the right, print them in a loop
+		while (true) {
+			expr_print_sub(self, e->c, simple, PREC_OR, expr_print1);
+			outs(self, " ? ");
+			if (e->a)
+				expr_print_sub(self, e->a, simple, PREC_COMMA, expr_print1);
+			outs(self, " : ");
+			if (e->b->type != EXPR_COND) {
+				expr_print_sub(self, e->b, simple, PREC_COND, expr_print1);
+				break;
+			}
+			if (expr_needs_parens(self, e->b, PREC_COND, expr_print1)) {
+				lp(self);
+				nested++;
+			}
+			e = (ExprCOND *) e->b;
+		}
+		while (nested--)
+			rp(self);
 		break;
 	}
 	case EXPR_CAST: {
 		ExprCAST *e = (ExprCAST *) h;
-		printf("(");
+		outs(self, "(");
 		type_print_vardecl(self, 0, e->t, "", simple);
-		if (e->e->type == EXPR_INIT) {
-			printf(") ");
+		if (expr_isinit(e->e)) {
+			outs(self, ") ");
 			expr_print(self, e->e, simple);
 		} else {
-			printf(") ");
-			expr_print1(self, e->e, simple);
+			outs(self, ") ");
+			expr_print_sub(self, e->e, simple, PREC_CAST, expr_print1);
 		}
 		break;
 	}
 	case EXPR_SIZEOF: {
 		ExprSIZEOF *e = (ExprSIZEOF *) h;
-		printf("sizeof ");
-		expr_print1(self, e->e, simple);
+		outs(self, "sizeof ");
+		bool literal = e->e->type == EXPR_CAST &&
+			expr_isinit(((ExprCAST *) e->e)->e);
+		expr_print_sub(self, e->e, simple,
+			       literal ? PREC_PRIMARY : PREC_UNARY, expr_print1);
 		break;
 	}
 	case EXPR_SIZEOFT: {
 		ExprSIZEOFT *e = (ExprSIZEOFT *) h;
-		printf("sizeof (");
+		outs(self, "sizeof (");
 		type_print_vardecl(self, 0, e->t, "", simple);
-		printf(")");
+		outs(self, ")");
 		break;
 	}
 	case EXPR_ALIGNOF: {
 		ExprALIGNOF *e = (ExprALIGNOF *) h;
 		if (e->t->type == TYPE_TYPEOF) {
 			TypeTYPEOF *t = (TypeTYPEOF *) e->t;
-			printf("__alignof__(");
+			outs(self, "__alignof__(");
 			expr_print(self, t->e, simple);
-			printf(")");
+			outs(self, ")");
 		} else {
-			printf("_Alignof (");
+			outs(self, "_Alignof (");
 			type_print_vardecl(self, 0, e->t, "", simple);
-			printf(")");
+			outs(self, ")");
 		}
 		break;
 	}
 	case EXPR_INIT: {
 		ExprINIT *e = (ExprINIT *) h;
-		printf("{\n");
+		outs(self, "{\n");
 		ExprINITItem p;
 		int i;
 		avec_foreach(&e->items, p, i) {
-			if (i) printf(",\n");
-			printf("\t");
+			if (i) outs(self, ",\n");
+			outs(self, "\t");
 			if (p.designator) {
 				Designator *d = p.designator;
 				while (d) {
 					switch(d->type) {
 					case DES_INDEX:
-						printf("[");
+						outs(self, "[");
 						expr_print(self, d->index, simple);
-						printf("]");
+						outs(self, "]");
 						break;
 					case DES_FIELD:
-						printf(".%s", d->field);
+						outf(self, ".%s", d->field);
 						break;
 					case DES_INDEXRANGE:
-						printf("[");
+						outs(self, "[");
 						expr_print(self, d->index, simple);
-						printf(" ... ");
+						outs(self, " ... ");
 						expr_print(self, d->indexhigh, simple);
-						printf("]");
+						outs(self, "]");
 						break;
 					}
 					d = d->next;
 				}
-				printf(" = ");
+				outs(self, " = ");
 			}
 			expr_print2(self, p.value, simple);
 		}
-		printf("\n}");
+		outs(self, "\n}");
 		break;
 	}
+	case EXPR_INITPACK:
+		initpack_print(self, (ExprINITPACK *) h);
+		break;
 	case EXPR_VASTART: {
 		ExprVASTART *e = (ExprVASTART *) h;
-		printf("__builtin_va_start(");
+		outs(self, "__builtin_va_start(");
 		expr_print2(self, e->ap, simple);
-		printf(", ");
-		printf("%s ", e->last);
-		printf(")");
+		outs(self, ", ");
+		outf(self, "%s ", e->last);
+		outs(self, ")");
 		break;
 	}
 	case EXPR_VAARG: {
 		ExprVAARG *e = (ExprVAARG *) h;
-		printf("__builtin_va_arg(");
+		outs(self, "__builtin_va_arg(");
 		expr_print2(self, e->ap, simple);
-		printf(", ");
+		outs(self, ", ");
 		type_print_vardecl(self, 0, e->type, "", simple);
-		printf(")");
+		outs(self, ")");
 		break;
 	}
 	case EXPR_VAEND: {
 		ExprVAEND *e = (ExprVAEND *) h;
-		printf("__builtin_va_end(");
-		expr_print1(self, e->ap, simple);
-		printf(")");
+		outs(self, "__builtin_va_end(");
+		expr_print_sub(self, e->ap, simple, PREC_ASSIGN, expr_print1);
+		outs(self, ")");
 		break;
 	}
 	case EXPR_OFFSETOF: {
 		ExprOFFSETOF *e = (ExprOFFSETOF *) h;
-		printf("__builtin_offsetof( ");
+		outs(self, "__builtin_offsetof( ");
 		type_print_vardecl(self, 0, e->type, "", simple);
-		printf(", ");
+		outs(self, ", ");
 		print_memlist(self, e->mem);
-		printf(")");
+		outs(self, ")");
 		break;
 	}
 	case EXPR_STMT: {
 		ExprSTMT *e = (ExprSTMT *) h;
 		if (simple)
-			printf("({/* ... */})");
+			outs(self, "({/* ... */})");
 		else {
-			printf("(");
+			outs(self, "(");
 			stmt_print(self, (Stmt *) e->s, 0);
-			printf(")");
+			outs(self, ")");
 		}
 		break;
 	}
 	case EXPR_GENERIC: {
 		ExprGENERIC *e = (ExprGENERIC *) h;
-		printf("_Generic(");
+		outs(self, "_Generic(");
 		expr_print2(self, e->expr, simple);
 		GENERICPair *item;
 		int i;
 		avec_foreach_ptr(&e->items, item, i) {
-			printf(", ");
+			outs(self, ", ");
 			if (item->type)
 				type_print_vardecl(self, 0, item->type, "", simple);
 			else
-				printf("default");
-			printf(": ");
+				outs(self, "default");
+			outs(self, ": ");
 			expr_print2(self, item->expr, simple);
 		}
-		printf(")");
+		outs(self, ")");
 		break;
 	}
 	case EXPR_TYPESCOMPATIBLE: {
 		ExprTYPESCOMPATIBLE *e = (ExprTYPESCOMPATIBLE *) h;
-		printf("__builtin_types_compatible_p( ");
+		outs(self, "__builtin_types_compatible_p( ");
 		type_print_vardecl(self, 0, e->type1, "", simple);
-		printf(", ");
+		outs(self, ", ");
 		type_print_vardecl(self, 0, e->type2, "", simple);
-		printf(")");
+		outs(self, ")");
 		break;
 	}
 	case EXPR_TYPENAME: {
 		ExprTYPENAME *e = (ExprTYPENAME *) h;
-		printf("0 /* __typename__( ");
+		outs(self, "0 /* __typename__( ");
 		type_print_vardecl(self, 0, e->type, "", simple);
-		printf(") */");
+		outs(self, ") */");
 		break;
 	}
 	}
 }
 
-static void print_level(int level)
+static void print_level(Printer *self, int level)
 {
 	for (int i = 0; i < level; i++)
-		printf("\t");
+		outs(self, "\t");
 }
 
 static void stmt_printb(Printer *self, Stmt *h, int level)
@@ -938,30 +1777,186 @@ static void stmt_printb(Printer *self, Stmt *h, int level)
 
 static void attrs_print(Printer *self, Attribute *attrs)
 {
-	printf("__attribute__((");
+	outs(self, "__attribute__((");
 	for (Attribute *a = attrs; a; a = a->next) {
-		printf("%s", a->name);
+		outs(self, a->name);
 		if (a->args.length) {
-			printf("(");
+			outs(self, "(");
 			Expr *p;
 			int i;
 			avec_foreach(&a->args, p, i) {
-				if (i) printf(", ");
+				if (i) outs(self, ", ");
 				expr_print2(self, p, false);
 			}
-			printf(")");
+			outs(self, ")");
 		}
 		if (a->next)
-			printf(", ");
+			outs(self, ", ");
 	}
-	printf("))");
+	outs(self, "))");
+}
+
+// a line ahead closer than this is reached with newlines, not a marker
+#define LOC_GAP 8
+// include chains deeper than this are cut at the top
+#define LOC_DEPTH 200
+
+static void loc_newline(Printer *self)
+{
+	if (self->compact) {
+		compact_put(self, '\n');
+		self->cspace = false;
+	} else {
+		outc(self, '\n');
+	}
+}
+
+// a line marker with the flags of file and flag, 1 or 2, if any
+static void print_marker(Printer *self, int file, int line, int flag)
+{
+	if (self->clast && self->clast != '\n')
+		loc_newline(self);
+	outf(self, "# %d \"", line);
+	const char *path = loctable_path(self->locs, file);
+	for (const char *q = path; *q; q++) {
+		if (*q == '"' || *q == '\\')
+			outc(self, '\\');
+		outc(self, *q);
+	}
+	outc(self, '"');
+	int flags = flag | loctable_flags(self->locs, file);
+	for (int i = 1; i <= 4; i++)
+		if (flags & 1 << i)
+			outf(self, " %d", i);
+	outc(self, '\n');
+	self->lline = line;
+	self->lbase = self->nlines;
+	self->lsync = true;
+}
+
+/* markers to line of file.  The compiler follows the includes the
+   markers enter and leave, and ignores a marker leaving to any other
+   file than the one entered from; so the markers go back to the
+   includer shared with file, then enter the files down to it. */
+static void loc_move(Printer *self, int file, int line)
+{
+	int chain[LOC_DEPTH], n = 0;
+	for (int f = file; f >= 0 && n < LOC_DEPTH;
+	     f = loctable_parent(self->locs, f))
+		chain[n++] = f;
+	// chain[n - 1] is the main file, and stack.data[0] too once known
+	vec_int_t *stack = &self->lstack;
+	int m = stack->length, k = 0;
+	while (k < m && k < n && stack->data[k] == chain[n - 1 - k])
+		k++;
+	int keep = k ? k : 1;
+	while (stack->length > keep) {
+		stack->length--;
+		print_marker(self, stack->data[stack->length - 1],
+			     k == n && stack->length == keep ? line : 1,
+			     LINE_LEAVE);
+	}
+	if (!k) {
+		// another main file, such as after <command-line>
+		vec_clear(stack);
+		vec_push(stack, chain[n - 1]);
+		print_marker(self, chain[n - 1], n == 1 ? line : 1, 0);
+		k = 1;
+	} else if (k == n && m == n) {
+		print_marker(self, file, line, 0);
+	}
+	for (; k < n; k++) {
+		vec_push(stack, chain[n - 1 - k]);
+		print_marker(self, chain[n - 1 - k], k == n - 1 ? line : 1,
+			     LINE_ENTER);
+	}
+}
+
+/* leaves the includes entered, so that the output of another printer
+   can follow, starting in the main file */
+static void loc_leave_includes(Printer *self)
+{
+	if (self->lstack.length > 1)
+		loc_move(self, self->lstack.data[0], 1);
+}
+
+/* steer the output line to where h was parsed: a few newlines when
+   it is just ahead, line markers otherwise */
+static void print_loc(Printer *self, Stmt *h)
+{
+	int file, line;
+	if (!self->locs || !loctable_get(self->locs, h, &file, &line))
+		return;
+	if (!self->compact && self->clast && self->clast != '\n')
+		return;
+	vec_int_t *stack = &self->lstack;
+	// input without markers: output and input lines start together
+	bool unnamed = !*loctable_path(self->locs, file);
+	if (unnamed && !stack->length && !self->hold && !self->nlines) {
+		vec_push(stack, file);
+		self->lline = 1;
+		self->lsync = true;
+	}
+	int cur = self->lline + (int) (self->nlines - self->lbase);
+	bool here = self->lsync && stack->length &&
+		stack->data[stack->length - 1] == file;
+	if (here && line == cur)
+		return;
+	if (here && line > cur && line - cur <= LOC_GAP) {
+		while (cur++ < line)
+			loc_newline(self);
+		return;
+	}
+	// no marker can name the file
+	if (unnamed)
+		return;
+	loc_move(self, file, line);
+}
+
+/* input text kept as is, ending its line.  It is not compacted even
+   in compact mode: its newlines keep the lines of diagnostics and debug
+   info right. */
+static void print_text(Printer *self, const char *s, int n)
+{
+	// print_loc() has put the line where the text starts
+	if (self->compact && self->clast && self->clast != '\n')
+		compact_put(self, ' ');
+	char *p = out_reserve(self, n + 1);
+	memcpy(p, s, n);
+	p[n] = '\n';
+	self->buf.length += n + 1;
+	out_track(self, p, n + 1);
+	self->cspace = false;
+	self->cnumber = false;
+	if (self->buf.length >= PRINTER_FLUSH && !self->hold)
+		printer_flush(self);
+	// line markers in the text move the output line
+	for (const char *q = s; (q = memchr(q, '\n', s + n - q)); q++)
+		if (q + 1 < s + n && q[1] == '#')
+			self->lsync = false;
 }
 
 static void stmt_print(Printer *self, Stmt *h, int level)
 {
+	print_loc(self, h);
 	if (h->type == STMT_PRAGMA) {
 		StmtPRAGMA *s = (StmtPRAGMA *) h;
-		printf("\n#pragma %s\n", s->line);
+		outf(self, "\n#pragma %s\n", s->line);
+		return;
+	}
+	if (h->type == STMT_OPAQUE) {
+		StmtOPAQUE *s = (StmtOPAQUE *) h;
+		print_text(self, s->text, s->len);
+		return;
+	}
+	if (h->type == STMT_SKIM) {
+		StmtSKIM *s = (StmtSKIM *) h;
+		print_text(self, s->text, s->len);
+		return;
+	}
+	if (h->type == STMT_LAZY) {
+		StmtLAZY *s = (StmtLAZY *) h;
+		print_text(self, s->text, s->len);
 		return;
 	}
 	if (h->type != STMT_DECLS) {
@@ -970,188 +1965,188 @@ static void stmt_print(Printer *self, Stmt *h, int level)
 		     h->type == STMT_DEFAULT ||
 		     h->type == STMT_LABEL))
 			level--;
-		print_level(level);
+		print_level(self, level);
 	}
 	switch (h->type) {
 	case STMT_EXPR: {
 		StmtEXPR *s = (StmtEXPR *) h;
 		expr_print(self, s->expr, false);
-		printf(";\n");
+		outs(self, ";\n");
 		break;
 	}
 	case STMT_IF: {
 		StmtIF *s = (StmtIF *) h;
-		printf("if (");
+		outs(self, "if (");
 		expr_print_cond(self, s->cond, false);
-		printf(")\n");
+		outs(self, ")\n");
 		stmt_printb(self, s->body1, level + 1);
 		if (s->body2) {
-			print_level(level);
-			printf("else\n");
+			print_level(self, level);
+			outs(self, "else\n");
 			if (s->body2->type == STMT_IF) {
 				stmt_printb(self, s->body2, level);
 			} else {
 				stmt_printb(self, s->body2, level + 1);
 			}
 		}
-		printf("\n");
+		outs(self, "\n");
 		break;
 	}
 	case STMT_WHILE: {
 		StmtWHILE *s = (StmtWHILE *) h;
-		printf("while (");
+		outs(self, "while (");
 		expr_print_cond(self, s->cond, false);
-		printf(")\n");
+		outs(self, ")\n");
 		stmt_printb(self, s->body, level + 1);
-		printf("\n");
+		outs(self, "\n");
 		break;
 	}
 	case STMT_DO: {
 		StmtDO *s = (StmtDO *) h;
-		printf("do\n");
+		outs(self, "do\n");
 		stmt_printb(self, s->body, level + 1);
-		print_level(level);
-		printf("while (");
+		print_level(self, level);
+		outs(self, "while (");
 		expr_print_cond(self, s->cond, false);
-		printf(");\n");
+		outs(self, ");\n");
 		break;
 	}
 	case STMT_FOR: {
 		StmtFOR *s = (StmtFOR *) h;
-		printf("for (");
+		outs(self, "for (");
 		if (s->init) expr_print(self, s->init, false);
-		printf("; ");
+		outs(self, "; ");
 		if (s->cond) expr_print_cond(self, s->cond, false);
-		printf("; ");
+		outs(self, "; ");
 		if (s->step) expr_print(self, s->step, false);
-		printf(")\n");
+		outs(self, ")\n");
 		stmt_printb(self, s->body, level + 1);
-		printf("\n");
+		outs(self, "\n");
 		break;
 	}
 	case STMT_FOR99: {
 		StmtFOR99 *s = (StmtFOR99 *) h;
 		if (s->init->type == STMT_VARDECL) {
-			printf("for (");
+			outs(self, "for (");
 			stmt_print(self, s->init, 0);
 			if (s->cond) expr_print_cond(self, s->cond, false);
-			printf("; ");
+			outs(self, "; ");
 			if (s->step) expr_print(self, s->step, false);
-			printf(")\n");
+			outs(self, ")\n");
 			stmt_printb(self, s->body, level + 1);
-			printf("\n");
+			outs(self, "\n");
 		} else if (s->init->type == STMT_DECLS) {
-			printf("{\n");
+			outs(self, "{\n");
 			stmt_print(self, s->init, level);
-			print_level(level);
-			printf("for (; ");
+			print_level(self, level);
+			outs(self, "for (; ");
 			if (s->cond) expr_print_cond(self, s->cond, false);
-			printf("; ");
+			outs(self, "; ");
 			if (s->step) expr_print(self, s->step, false);
-			printf(")\n");
+			outs(self, ")\n");
 			stmt_printb(self, s->body, level + 1);
-			print_level(level);
-			printf("}\n");
+			print_level(self, level);
+			outs(self, "}\n");
 		} else {
 			abort();
 		}
 		break;
 	}
 	case STMT_BREAK: {
-		printf("break;\n");
+		outs(self, "break;\n");
 		break;
 	}
 	case STMT_CONTINUE: {
-		printf("continue;\n");
+		outs(self, "continue;\n");
 		break;
 	}
 	case STMT_SWITCH: {
 		StmtSWITCH *s = (StmtSWITCH *) h;
-		printf("switch (");
+		outs(self, "switch (");
 		expr_print(self, s->expr, false);
-		printf(")\n");
+		outs(self, ")\n");
 		stmt_printb(self, s->body, level + 1);
-		printf("\n");
+		outs(self, "\n");
 		break;
 	}
 	case STMT_CASE: {
 		StmtCASE *s = (StmtCASE *) h;
-		printf("case ");
-		expr_print1(self, s->expr, false);
-		printf(":\n");
+		outs(self, "case ");
+		expr_print_sub(self, s->expr, false, PREC_COND, expr_print1);
+		outs(self, ":\n");
 		stmt_print(self, s->stmt, level + 1);
 		break;
 	}
 	case STMT_DEFAULT: {
 		StmtDEFAULT *s = (StmtDEFAULT *) h;
-		printf("default:\n");
+		outs(self, "default:\n");
 		stmt_print(self, s->stmt, level + 1);
 		break;
 	}
 	case STMT_LABEL: {
 		StmtLABEL *s = (StmtLABEL *) h;
-		printf("%s:\n", s->name);
+		outf(self, "%s:\n", s->name);
 		stmt_print(self, s->stmt, level + 1);
 		break;
 	}
 	case STMT_GOTO: {
 		StmtGOTO *s = (StmtGOTO *) h;
-		printf("goto %s;\n", s->name);
+		outf(self, "goto %s;\n", s->name);
 		break;
 	}
 	case STMT_RETURN: {
 		StmtRETURN *s = (StmtRETURN *) h;
 		if (s->expr) {
-			printf("return ");
+			outs(self, "return ");
 			expr_print(self, s->expr, false);
-			printf(";\n");
+			outs(self, ";\n");
 		} else {
-			printf("return;\n");
+			outs(self, "return;\n");
 		}
 		break;
 	}
 	case STMT_SKIP: {
 		StmtSKIP *s = (StmtSKIP *) h;
-		printf("/*skip*/");
+		outs(self, "/*skip*/");
 		if (s->attrs) {
-			printf(" ");
+			outs(self, " ");
 			attrs_print(self, s->attrs);
 		}
-		printf(";\n");
+		outs(self, ";\n");
 		break;
 	}
 	case STMT_BLOCK: {
 		StmtBLOCK *s = (StmtBLOCK *) h;
-		printf("{\n");
+		outs(self, "{\n");
 		Stmt *p;
 		int i;
 		avec_foreach(&s->items, p, i) {
 			stmt_print(self, p, level + 1);
 		}
-		print_level(level);
-		printf("}\n");
+		print_level(self, level);
+		outs(self, "}\n");
 		break;
 	}
 	case STMT_FUNDECL: {
 		StmtFUNDECL *s = (StmtFUNDECL *) h;
 		if (self->print_type_annot) {
-			printf("// fundecl: %s, type: ", s->name);
+			outf(self, "// fundecl: %s, type: ", s->name);
 			type_print_annot(self, &s->type->h, true);
-			printf("\n");
-			print_level(level);
+			outs(self, "\n");
+			print_level(self, level);
 		}
 		type_print_fundecl(self, s->flags, s->type, s->args, s->name, s->ext.gcc_attribute);
 		if (s->ext.gcc_asm_name) {
-			printf(" __asm__(\"");
+			outs(self, " __asm__(\"");
 			int len = strlen(s->ext.gcc_asm_name);
-			print_quoted(s->ext.gcc_asm_name, len);
-			printf("\")");
+			print_quoted(self, s->ext.gcc_asm_name, len);
+			outs(self, "\")");
 		}
 		if (s->body) {
-			printf("\n");
+			outs(self, "\n");
 			stmt_print(self, &s->body->h, level);
 		} else {
-			printf(";\n");
+			outs(self, ";\n");
 		}
 		break;
 	}
@@ -1159,71 +2154,71 @@ static void stmt_print(Printer *self, Stmt *h, int level)
 		StmtVARDECL *s = (StmtVARDECL *) h;
 		if (self->print_type_annot) {
 			if (s->name)
-				printf("// vardecl: %s, type: ", s->name);
+				outf(self, "// vardecl: %s, type: ", s->name);
 			else
-				printf("// vardecl: /* unnamed */, type: ");
+				outs(self, "// vardecl: /* unnamed */, type: ");
 			type_print_annot(self, s->type, true);
 			if (s->bitfield) {
-				printf(", bitfield : ");
+				outs(self, ", bitfield : ");
 				expr_print1(self, s->bitfield, true);
 			}
-			printf("\n");
-			print_level(level);
+			outs(self, "\n");
+			print_level(self, level);
 		}
 		if (s->ext.c11_alignas) {
-			printf("_Alignas(");
+			outs(self, "_Alignas(");
 			if (s->ext.c11_alignas->type == EXPR_ALIGNOF) {
 				ExprALIGNOF *e = (ExprALIGNOF *) (s->ext.c11_alignas);
 				type_print_vardecl(self, 0, e->t, "", false);
 			} else {
 				expr_print(self, s->ext.c11_alignas, false);
 			}
-			printf(") ");
+			outs(self, ") ");
 		}
 		type_print_vardecl(self, s->flags, s->type, s->name, false);
 		if (s->bitfield) {
-			printf(" : ");
-			expr_print1(self, s->bitfield, false);
+			outs(self, " : ");
+			expr_print_sub(self, s->bitfield, false, PREC_COND, expr_print1);
 		}
 		if (s->ext.gcc_asm_name) {
-			printf(" __asm__(\"");
+			outs(self, " __asm__(\"");
 			int len = strlen(s->ext.gcc_asm_name);
-			print_quoted(s->ext.gcc_asm_name, len);
-			printf("\")");
+			print_quoted(self, s->ext.gcc_asm_name, len);
+			outs(self, "\")");
 		}
 		if (s->ext.gcc_attribute) {
-			printf(" ");
+			outs(self, " ");
 			attrs_print(self, s->ext.gcc_attribute);
 		}
 		if (s->init) {
-			printf(" = ");
+			outs(self, " = ");
 			expr_print2(self, s->init, false);
 		}
-		printf(";\n");
+		outs(self, ";\n");
 		break;
 	}
 	case STMT_TYPEDEF: {
 		StmtTYPEDEF *s = (StmtTYPEDEF *) h;
 		if (self->print_type_annot) {
-			printf("// typedef: %s, type: ", s->name);
+			outf(self, "// typedef: %s, type: ", s->name);
 			type_print_annot(self, s->type, true);
-			printf("\n");
-			print_level(level);
+			outs(self, "\n");
+			print_level(self, level);
 		}
 		if (s->name) {
 			if (strcmp(s->name, "_Float32") == 0 ||
 			    strcmp(s->name, "_Float64") == 0 ||
 			    strcmp(s->name, "_Float32x") == 0 ||
 			    strcmp(s->name, "_Float64x") == 0)
-				printf("// ");
+				outs(self, "// ");
 		}
-		printf("typedef ");
+		outs(self, "typedef ");
 		type_print_vardecl(self, 0, s->type, s->name, false);
 		if (s->ext.gcc_attribute) {
-			printf(" ");
+			outs(self, " ");
 			attrs_print(self, s->ext.gcc_attribute);
 		}
-		printf(";\n");
+		outs(self, ";\n");
 		break;
 	}
 	case STMT_DECLS: {
@@ -1237,98 +2232,98 @@ static void stmt_print(Printer *self, Stmt *h, int level)
 	}
 	case STMT_GOTOADDR: {
 		StmtGOTOADDR *s = (StmtGOTOADDR *) h;
-		printf("goto ");
+		outs(self, "goto ");
 		expr_print(self, s->expr, false);
-		printf(";\n");
+		outs(self, ";\n");
 		break;
 	}
 	case STMT_LABELDECL: {
 		StmtLABELDECL *s = (StmtLABELDECL *) h;
-		printf("__label__ %s;\n", s->name);
+		outf(self, "__label__ %s;\n", s->name);
 		break;
 	}
 	case STMT_CASERANGE: {
 		StmtCASERANGE *s = (StmtCASERANGE *) h;
-		printf("case ");
-		expr_print1(self, s->low, false);
-		printf(" ... ");
-		expr_print1(self, s->high, false);
-		printf(":\n");
+		outs(self, "case ");
+		expr_print_sub(self, s->low, false, PREC_COND, expr_print1);
+		outs(self, " ... ");
+		expr_print_sub(self, s->high, false, PREC_COND, expr_print1);
+		outs(self, ":\n");
 		stmt_print(self, s->stmt, level + 1);
 		break;
 	}
 	case STMT_ASM: {
 		int i;
 		StmtASM *s = (StmtASM *) h;
-		printf("__asm__");
+		outs(self, "__asm__");
 		if (s->flags & ASM_FLAG_VOLATILE)
-			printf(" volatile");
+			outs(self, " volatile");
 		if (s->flags & ASM_FLAG_INLINE)
-			printf(" inline");
+			outs(self, " inline");
 		if (s->flags & ASM_FLAG_GOTO)
-			printf(" goto");
-		printf(" (\"");
-		print_quoted(s->content, strlen(s->content));
-		printf("\"");
+			outs(self, " goto");
+		outs(self, " (\"");
+		print_quoted(self, s->content, strlen(s->content));
+		outs(self, "\"");
 		if (s->outputs.length == 0 &&
 		    s->inputs.length == 0 &&
 		    s->clobbers.length == 0 &&
 		    s->gotolabels.length == 0) {
-			printf(");\n");
+			outs(self, ");\n");
 			break;
 		}
-		printf(" : ");
+		outs(self, " : ");
 		ASMOper *oper;
 		avec_foreach_ptr(&s->outputs, oper, i) {
-			if (i) printf(", ");
+			if (i) outs(self, ", ");
 			if (oper->symbol)
-				printf("[%s] ", oper->symbol);
-			printf("\"");
-			print_quoted(oper->constraint, strlen(oper->constraint));
-			printf("\" (");
+				outf(self, "[%s] ", oper->symbol);
+			outs(self, "\"");
+			print_quoted(self, oper->constraint, strlen(oper->constraint));
+			outs(self, "\" (");
 			expr_print(self, oper->variable, false);
-			printf(")");
+			outs(self, ")");
 		}
-		printf(" : ");
+		outs(self, " : ");
 		avec_foreach_ptr(&s->inputs, oper, i) {
-			if (i) printf(", ");
+			if (i) outs(self, ", ");
 			if (oper->symbol)
-				printf("[%s] ", oper->symbol);
-			printf("\"");
-			print_quoted(oper->constraint, strlen(oper->constraint));
-			printf("\" (");
+				outf(self, "[%s] ", oper->symbol);
+			outs(self, "\"");
+			print_quoted(self, oper->constraint, strlen(oper->constraint));
+			outs(self, "\" (");
 			expr_print(self, oper->variable, false);
-			printf(")");
+			outs(self, ")");
 		}
-		printf(" : ");
+		outs(self, " : ");
 		const char *clobber;
 		avec_foreach(&s->clobbers, clobber, i) {
-			if (i) printf(", ");
-			printf("\"");
-			print_quoted(clobber, strlen(clobber));
-			printf("\"");
+			if (i) outs(self, ", ");
+			outs(self, "\"");
+			print_quoted(self, clobber, strlen(clobber));
+			outs(self, "\"");
 		}
 		if (s->gotolabels.length) {
-			printf(" : ");
+			outs(self, " : ");
 			const char *label;
 			avec_foreach(&s->gotolabels, label, i) {
-				if (i) printf(", ");
-				printf("%s", label);
+				if (i) outs(self, ", ");
+				outs(self, label);
 			}
 		}
-		printf(");\n");
+		outs(self, ");\n");
 		break;
 	}
 	case STMT_STATICASSERT: {
 		StmtSTATICASSERT *s = (StmtSTATICASSERT *) h;
-		printf("_Static_assert(");
+		outs(self, "_Static_assert(");
 		expr_print2(self, s->expr, false);
 		if (s->errmsg) {
-			printf(", \"");
-			print_quoted(s->errmsg, strlen(s->errmsg));
-			printf("\"");
+			outs(self, ", \"");
+			print_quoted(self, s->errmsg, strlen(s->errmsg));
+			outs(self, "\"");
 		}
-		printf(");\n");
+		outs(self, ");\n");
 		break;
 	}
 	default:
@@ -1343,6 +2338,131 @@ void printer_print_translation_unit(Printer *self, StmtBLOCK *s)
 	avec_foreach(&s->items, p, i) {
 		stmt_print(self, p, 0);
 	}
+	compact_end_line(self);
+	printer_flush(self);
+}
+
+#define CHUNKS_PER_THREAD 8
+
+struct print_job {
+	Printer *self;
+	StmtBLOCK *tu;
+	Printer *chunks;
+	int nchunks;
+	int next;
+	pthread_mutex_t lock;
+};
+
+static void printer_init(Printer *p);
+static void printer_copy_settings(Printer *p, Printer *from)
+{
+	p->print_type_annot = from->print_type_annot;
+	p->minimal_parens = from->minimal_parens;
+	p->compact = from->compact;
+	p->locs = from->locs;
+}
+
+static void *print_worker(void *arg)
+{
+	struct print_job *job = arg;
+	int nitems = job->tu->items.length;
+	while (true) {
+		pthread_mutex_lock(&job->lock);
+		int i = job->next++;
+		pthread_mutex_unlock(&job->lock);
+		if (i >= job->nchunks)
+			break;
+		Printer *p = &job->chunks[i];
+		printer_init(p);
+		printer_copy_settings(p, job->self);
+		p->hold = true;
+		int begin = (long) nitems * i / job->nchunks;
+		int end = (long) nitems * (i + 1) / job->nchunks;
+		for (int k = begin; k < end; k++)
+			stmt_print(p, job->tu->items.data[k], 0);
+		loc_leave_includes(p);
+		compact_end_line(p);
+	}
+	return NULL;
+}
+
+static bool write_all(struct iovec *iov, int n)
+{
+	while (n > 0) {
+		int cnt = n < 1024 ? n : 1024;
+		ssize_t w = writev(STDOUT_FILENO, iov, cnt);
+		if (w < 0)
+			return false;
+		while (cnt > 0 && (size_t) w >= iov->iov_len) {
+			w -= iov->iov_len;
+			iov++, n--, cnt--;
+		}
+		if (cnt > 0) {
+			iov->iov_base = (char *) iov->iov_base + w;
+			iov->iov_len -= w;
+		}
+	}
+	return true;
+}
+
+/* top-level items are independent: render contiguous chunks of them on
+   nthreads threads and write the buffers out in order */
+void printer_print_translation_unit_parallel(Printer *self, StmtBLOCK *s,
+					     int nthreads)
+{
+	int nchunks = nthreads * CHUNKS_PER_THREAD;
+	if (nthreads <= 1 || s->items.length < nchunks) {
+		printer_print_translation_unit(self, s);
+		return;
+	}
+
+	struct print_job job = {
+		.self = self,
+		.tu = s,
+		.chunks = malloc(nchunks * sizeof(Printer)),
+		.nchunks = nchunks,
+		.next = 0,
+	};
+	pthread_mutex_init(&job.lock, NULL);
+	pthread_t *tids = malloc((nthreads - 1) * sizeof(pthread_t));
+	int started = 0;
+	for (; started < nthreads - 1; started++)
+		if (pthread_create(&tids[started], NULL, print_worker, &job))
+			break;
+	print_worker(&job);
+	for (int i = 0; i < started; i++)
+		pthread_join(tids[i], NULL);
+	pthread_mutex_destroy(&job.lock);
+	free(tids);
+
+	printer_flush(self);
+	fflush(stdout);
+	struct iovec *iov = malloc(nchunks * sizeof(struct iovec));
+	int n = 0;
+	for (int i = 0; i < nchunks; i++) {
+		Printer *p = &job.chunks[i];
+		if (p->buf.length)
+			iov[n++] = (struct iovec) { p->buf.data, p->buf.length };
+		self->written += p->buf.length;
+	}
+	write_all(iov, n);
+	free(iov);
+	for (int i = 0; i < nchunks; i++) {
+		vec_deinit(&job.chunks[i].buf);
+		vec_deinit(&job.chunks[i].spine);
+		vec_deinit(&job.chunks[i].lstack);
+	}
+	free(job.chunks);
+}
+
+void printer_print_decl(Printer *self, Stmt *s)
+{
+	stmt_print(self, s, 0);
+}
+
+long printer_output_bytes(Printer *p)
+{
+	return p->written + p->buf.length;
 }
 
 void printer_set_print_type_annot(Printer *p, bool b)
@@ -1350,13 +2470,50 @@ void printer_set_print_type_annot(Printer *p, bool b)
 	p->print_type_annot = b;
 }
 
+void printer_set_minimal_parens(Printer *p, bool b)
+{
+	p->minimal_parens = b;
+}
+
+void printer_set_compact(Printer *p, bool b)
+{
+	p->compact = b;
+}
+
+void printer_set_locations(Printer *p, LocTable *t)
+{
+	p->locs = t;
+}
+
 static void printer_init(Printer *p)
 {
 	p->print_type_annot = false;
+	p->minimal_parens = false;
+	p->compact = false;
+	p->cstate = CS_CODE;
+	p->clast = 0;
+	p->cquote = 0;
+	p->cspace = false;
+	p->cnumber = false;
+	p->locs = NULL;
+	vec_init(&p->lstack);
+	p->lsync = false;
+	p->lline = 0;
+	p->nlines = 0;
+	p->lbase = 0;
+	p->hold = false;
+	vec_init(&p->buf);
+	p->written = 0;
+	vec_init(&p->spine);
 }
 
 static void printer_free(Printer *p)
 {
+	compact_end_line(p);
+	printer_flush(p);
+	vec_deinit(&p->buf);
+	vec_deinit(&p->spine);
+	vec_deinit(&p->lstack);
 }
 
 Printer *printer_new()
@@ -0,0 +1,145 @@
+#include "srcloc.h"
+#include "allocator.h"
+#include "vec.h"
+#include <stdint.h>
+#include <string.h>
+
+struct loc {
+	const void *node;
+	int file;
+	int line;
+	unsigned gen;
+};
+
+struct LocTable_ {
+	Allocator *allocator;
+	struct loc *slots;
+	int nslots;
+	int count;
+	unsigned gen;
+	vec_str_t files;
+	// of each file, its includer (or -1) and LINE_* flags
+	vec_int_t parents, flags;
+	int last;
+};
+
+static unsigned loc_hash(const void *node)
+{
+	uint64_t h = (uintptr_t) node >> 3;
+	return (h * 0x9e3779b97f4a7c15ull) >> 32;
+}
+
+// slots of an older generation count as empty
+static struct loc *loc_lookup(struct loc *slots, int nslots, unsigned gen,
+			      const void *node)
+{
+	unsigned i = loc_hash(node) & (nslots - 1);
+	while (slots[i].gen == gen && slots[i].node != node)
+		i = (i + 1) & (nslots - 1);
+	return &slots[i];
+}
+
+static void loc_grow(LocTable *t)
+{
+	int n = t->nslots ? t->nslots * 2 : 1024;
+	int size = n * sizeof(struct loc);
+	struct loc *slots = allocator_memalloc(t->allocator, size);
+	memset(slots, 0, size);
+	for (int i = 0; i < t->nslots; i++)
+		if (t->slots[i].gen == t->gen)
+			*loc_lookup(slots, n, t->gen, t->slots[i].node) = t->slots[i];
+	t->slots = slots;
+	t->nslots = n;
+}
+
+LocTable *loctable_new(Allocator *a)
+{
+	LocTable *t = allocator_memalloc(a, sizeof(LocTable));
+	t->allocator = a;
+	t->slots = NULL;
+	t->nslots = 0;
+	t->count = 0;
+	t->gen = 1;
+	vec_init(&t->files);
+	vec_init(&t->parents);
+	vec_init(&t->flags);
+	t->last = -1;
+	return t;
+}
+
+void loctable_delete(LocTable *t)
+{
+	vec_deinit(&t->files);
+	vec_deinit(&t->parents);
+	vec_deinit(&t->flags);
+}
+
+void loctable_clear(LocTable *t)
+{
+	t->gen++;
+	t->count = 0;
+}
+
+int loctable_find(LocTable *t, const char *path)
+{
+	if (t->last >= 0 && strcmp(t->files.data[t->last], path) == 0)
+		return t->last;
+	for (int i = t->files.length - 1; i >= 0; i--)
+		if (strcmp(t->files.data[i], path) == 0)
+			return t->last = i;
+	return -1;
+}
+
+int loctable_add(LocTable *t, const char *path, int parent, int flags)
+{
+	vec_push(&t->files, allocator_strdup(t->allocator, path));
+	vec_push(&t->parents, parent);
+	vec_push(&t->flags, flags);
+	return t->last = t->files.length - 1;
+}
+
+int loctable_file(LocTable *t, const char *path)
+{
+	int file = loctable_find(t, path);
+	return file >= 0 ? file : loctable_add(t, path, -1, 0);
+}
+
+int loctable_parent(LocTable *t, int file)
+{
+	return t->parents.data[file];
+}
+
+int loctable_flags(LocTable *t, int file)
+{
+	return t->flags.data[file];
+}
+
+const char *loctable_path(LocTable *t, int file)
+{
+	return t->files.data[file];
+}
+
+void loctable_set(LocTable *t, const void *node, int file, int line)
+{
+	if (t->count * 2 >= t->nslots)
+		loc_grow(t);
+	struct loc *l = loc_lookup(t->slots, t->nslots, t->gen, node);
+	if (l->gen != t->gen)
+		t->count++;
+	l->gen = t->gen;
+	l->node = node;
+	l->file = file;
+	l->line = line;
+}
+
+bool loctable_get(LocTable *t, const void *node, int *file, int *line)
+{
+	if (!t->count)
+		return false;
+	struct loc *l = loc_lookup(t->slots, t->nslots, t->gen, node);
+	if (l->gen != t->gen)
+		return false;
+	*file = l->file;
+	*line = l->line;
+	return true;
+}
@@ -1,5 +1,6 @@
 #include "tree.h"
 #include <stdlib.h>
+#include <assert.h>
 
 BEGIN_MANAGED
 
@@ -56,6 +57,34 @@ void exprINIT_append(ExprINIT *init, Designator *d, Expr *e)
 	(void) avec_push(&init->items, item);
 }
 
+ExprINITPACK *exprINITPACK(int kind, const int *values, int length)
+{
+	assert(length > 0);
+	ExprINITPACK *t = __new(ExprINITPACK);
+	t->h.type = EXPR_INITPACK;
+	t->kind = kind;
+	t->length = length;
+	t->width = 1;
+	for (int i = 0; i < length && t->width < 4; i++) {
+		long long v = kind == EXPR_INT_CST ? (long long) values[i] :
+			(unsigned int) values[i];
+		if (kind == EXPR_INT_CST ? v < -32768 || v > 32767 : v > 65535)
+			t->width = 4;
+		else if (kind == EXPR_INT_CST ? v < -128 || v > 127 : v > 255)
+			t->width = 2;
+	}
+	void *a = __new_(length * t->width);
+	for (int i = 0; i < length; i++) {
+		switch (t->width) {
+		case 1: ((unsigned char *) a)[i] = values[i]; break;
+		case 2: ((unsigned short *) a)[i] = values[i]; break;
+		case 4: ((unsigned int *) a)[i] = values[i]; break;
+		}
+	}
+	t->values = a;
+	return t;
+}
+
 ExprGENERIC *exprGENERIC(Expr *expr)
 {
 	ExprGENERIC *t = __new(ExprGENERIC);
@@ -134,8 +163,68 @@ void stmtASM_append_gotolabels(StmtASM *s, const char *name)
 	(void) avec_push(&s->gotolabels, name);
 }
 
+StmtSKIM *stmtSKIM()
+{
+	StmtSKIM *t = __new(StmtSKIM);
+	t->h.type = STMT_SKIM;
+	t->flags = 0;
+	t->text = NULL;
+	t->len = 0;
+	avec_init(&t->defs);
+	avec_init(&t->uses);
+	avec_init(&t->attrs);
+	return t;
+}
+
+void stmtSKIM_append_def(StmtSKIM *s, const char *name)
+{
+	(void) avec_push(&s->defs, name);
+}
+
+void stmtSKIM_append_use(StmtSKIM *s, const char *name)
+{
+	(void) avec_push(&s->uses, name);
+}
+
+void stmtSKIM_append_attr(StmtSKIM *s, const char *name)
+{
+	(void) avec_push(&s->attrs, name);
+}
+
+StmtLAZY *stmtLAZY(void *resume)
+{
+	StmtLAZY *t = __new(StmtLAZY);
+	t->h.type = STMT_LAZY;
+	t->text = NULL;
+	t->len = 0;
+	avec_init(&t->uses);
+	t->resume = resume;
+	return t;
+}
+
+void stmtLAZY_append_use(StmtLAZY *s, const char *name)
+{
+	(void) avec_push(&s->uses, name);
+}
+
 END_MANAGED
 
+long long exprINITPACK_get(ExprINITPACK *e, int i)
+{
+	bool sign = e->kind == EXPR_INT_CST;
+	switch (e->width) {
+	case 1:
+		return sign ? ((const signed char *) e->values)[i] :
+			((const unsigned char *) e->values)[i];
+	case 2:
+		return sign ? ((const short *) e->values)[i] :
+			((const unsigned short *) e->values)[i];
+	default:
+		return sign ? (long long) ((const int *) e->values)[i] :
+			((const unsigned int *) e->values)[i];
+	}
+}
+
 #define ARGCOUNT_IMPL(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, ...) _13
 #define ARGCOUNT(...) ARGCOUNT_IMPL(~, ## __VA_ARGS__,  12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
 #define PASTE0(a, b) a ## b
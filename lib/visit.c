@@ -0,0 +1,377 @@
+#include "visit.h"
+#include <assert.h>
+
+enum {
+	HOOK_STMT,
+	HOOK_EXPR,
+	HOOK_TYPE,
+};
+
+#define ARGCOUNT_IMPL(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, ...) _13
+#define ARGCOUNT(...) ARGCOUNT_IMPL(~, ## __VA_ARGS__, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define PASTE0(a, b) a ## b
+#define PASTE(a, b) PASTE0(a, b)
+
+static const unsigned char node_hook[] = {
+#define STMT(id, ...) [STMT_##id] = HOOK_STMT,
+#define EXPR(id, ...) [EXPR_##id] = HOOK_EXPR,
+#define TYPE(id, ...) [TYPE_##id] = HOOK_TYPE,
+#include "tree_nodes.def"
+#undef STMT
+#undef EXPR
+#undef TYPE
+	[STMT_BLOCK] = HOOK_STMT,
+	[STMT_DECLS] = HOOK_STMT,
+	[STMT_ASM] = HOOK_STMT,
+	[STMT_SKIM] = HOOK_STMT,
+	[STMT_LAZY] = HOOK_STMT,
+	[EXPR_CALL] = HOOK_EXPR,
+	[EXPR_INIT] = HOOK_EXPR,
+	[EXPR_INITPACK] = HOOK_EXPR,
+	[EXPR_GENERIC] = HOOK_EXPR,
+	[TYPE_FUN] = HOOK_TYPE,
+};
+
+// whether a field holds nodes, by its declared type
+#define HAS_NODES(p) _Generic((p),		\
+			       Tree **: 1,	\
+			       StmtBLOCK **: 1,	\
+			       TypeFUN **: 1,	\
+			       Attribute **: 1,	\
+			       Extension *: 1,	\
+			       EnumList **: 1,	\
+			       default: 0)
+
+#define INNER(N, v) HAS_NODES(&((N *) 0)->v) ||
+#define INNER_0(N)
+#define INNER_2(N, T1, v1) INNER(N, v1)
+#define INNER_4(N, T1, v1, ...) INNER(N, v1) INNER_2(N, __VA_ARGS__)
+#define INNER_6(N, T1, v1, ...) INNER(N, v1) INNER_4(N, __VA_ARGS__)
+#define INNER_8(N, T1, v1, ...) INNER(N, v1) INNER_6(N, __VA_ARGS__)
+#define INNER_10(N, T1, v1, ...) INNER(N, v1) INNER_8(N, __VA_ARGS__)
+#define INNER_12(N, T1, v1, ...) INNER(N, v1) INNER_10(N, __VA_ARGS__)
+#define LEAF(N, ...) \
+	!(PASTE(INNER_, ARGCOUNT(__VA_ARGS__))(N, ## __VA_ARGS__) 0)
+
+static const bool node_leaf[] = {
+#define STMT(id, ...) [STMT_##id] = LEAF(Stmt##id, ## __VA_ARGS__),
+#define EXPR(id, ...) [EXPR_##id] = LEAF(Expr##id, ## __VA_ARGS__),
+#define TYPE(id, ...) [TYPE_##id] = LEAF(Type##id, ## __VA_ARGS__),
+#include "tree_nodes.def"
+#undef STMT
+#undef EXPR
+#undef TYPE
+	[STMT_SKIM] = true,
+	[STMT_LAZY] = true,
+	[TYPE_FUN] = false,
+};
+
+static VisitPre pre_hook(Visitor *v, int kind)
+{
+	if (v->pre[kind])
+		return v->pre[kind];
+	switch (node_hook[kind]) {
+	case HOOK_STMT:
+		return v->stmt;
+	case HOOK_EXPR:
+		return v->expr;
+	default:
+		return v->type;
+	}
+}
+
+static VisitPost post_hook(Visitor *v, int kind)
+{
+	if (v->post[kind])
+		return v->post[kind];
+	switch (node_hook[kind]) {
+	case HOOK_STMT:
+		return v->stmt_post;
+	case HOOK_EXPR:
+		return v->expr_post;
+	default:
+		return v->type_post;
+	}
+}
+
+static void grow(PassManager *pm)
+{
+	vec_reserve(&pm->stack,
+		    pm->stack.capacity ? pm->stack.capacity * 2 : 256);
+}
+
+static inline void push(PassManager *pm, Tree *h, unsigned mask, bool post)
+{
+	if (pm->stack.length == pm->stack.capacity)
+		grow(pm);
+	VisitFrame *f = &pm->stack.data[pm->stack.length++];
+	f->node = h;
+	f->mask = mask;
+	f->post = post;
+}
+
+// leaves no pass has a hook for need no visit
+static inline void push_child(PassManager *pm, Tree *h, unsigned mask)
+{
+	int kind = h->type;
+	if (node_leaf[kind] && !(mask & (pm->pre[kind] | pm->post[kind])))
+		return;
+	push(pm, h, mask, false);
+}
+
+/* Children are pushed last to first, so that they are entered in
+   order.  The attr hooks run here, first to last. */
+static void push_attrs(PassManager *pm, unsigned mask, Attribute *a)
+{
+	if (!a)
+		return;
+	unsigned down = mask & ~pm->attr;
+	unsigned m;
+	for (m = mask & pm->attr; m; m &= m - 1) {
+		unsigned bit = m & -m;
+		Visitor *v = pm->passes[__builtin_ctz(m)];
+		switch (v->attr(v, a)) {
+		case VISIT_CONTINUE:
+			down |= bit;
+			break;
+		case VISIT_STOP:
+			pm->live &= ~bit;
+			break;
+		}
+	}
+	push_attrs(pm, mask & pm->live, a->next);
+	down &= pm->live;
+	for (int i = a->args.length - 1; down && i >= 0; i--)
+		push_child(pm, a->args.data[i], down);
+}
+
+static void push_ext(PassManager *pm, unsigned mask, Extension *ext)
+{
+	if (ext->c11_alignas)
+		push_child(pm, ext->c11_alignas, mask);
+	push_attrs(pm, mask, ext->gcc_attribute);
+}
+
+static void push_enums(PassManager *pm, unsigned mask, EnumList *list)
+{
+	if (!list)
+		return;
+	for (int i = list->items.length - 1; i >= 0; i--) {
+		struct EnumPair_ *item = &list->items.data[i];
+		if (item->val)
+			push_child(pm, item->val, mask);
+		push_attrs(pm, mask, item->attr);
+	}
+}
+
+static void push_designators(PassManager *pm, unsigned mask, Designator *d)
+{
+	if (!d)
+		return;
+	push_designators(pm, mask, d->next);
+	if (d->type == DES_INDEXRANGE)
+		push_child(pm, d->indexhigh, mask);
+	if (d->type != DES_FIELD)
+		push_child(pm, d->index, mask);
+}
+
+static void push_field_none(PassManager *pm, unsigned mask, void *p)
+{
+}
+
+static void push_field_tree(PassManager *pm, unsigned mask, void *p)
+{
+	Tree *h = *(Tree **) p;
+	if (h)
+		push_child(pm, h, mask);
+}
+
+static void push_field_attrs(PassManager *pm, unsigned mask, void *p)
+{
+	push_attrs(pm, mask, *(Attribute **) p);
+}
+
+static void push_field_ext(PassManager *pm, unsigned mask, void *p)
+{
+	push_ext(pm, mask, p);
+}
+
+static void push_field_enums(PassManager *pm, unsigned mask, void *p)
+{
+	push_enums(pm, mask, *(EnumList **) p);
+}
+
+// picked by the declared type of the field; scalars are not walked
+#define PUSH_FIELD(p) _Generic((p),				\
+			       Tree **: push_field_tree,	\
+			       StmtBLOCK **: push_field_tree,	\
+			       TypeFUN **: push_field_tree,	\
+			       Attribute **: push_field_attrs,	\
+			       Extension *: push_field_ext,	\
+			       EnumList **: push_field_enums,	\
+			       default: push_field_none)(pm, mask, (p))
+
+// the fields of a node, last to first
+#define CHILD(N, v) PUSH_FIELD(&((N *) h)->v);
+#define CHILDREN_0(N)
+#define CHILDREN_2(N, T1, v1) CHILD(N, v1)
+#define CHILDREN_4(N, T1, v1, ...) CHILDREN_2(N, __VA_ARGS__) CHILD(N, v1)
+#define CHILDREN_6(N, T1, v1, ...) CHILDREN_4(N, __VA_ARGS__) CHILD(N, v1)
+#define CHILDREN_8(N, T1, v1, ...) CHILDREN_6(N, __VA_ARGS__) CHILD(N, v1)
+#define CHILDREN_10(N, T1, v1, ...) CHILDREN_8(N, __VA_ARGS__) CHILD(N, v1)
+#define CHILDREN_12(N, T1, v1, ...) CHILDREN_10(N, __VA_ARGS__) CHILD(N, v1)
+#define CHILDREN(N, ...) \
+	PASTE(CHILDREN_, ARGCOUNT(__VA_ARGS__))(N, ## __VA_ARGS__)
+
+static void push_children(PassManager *pm, unsigned mask, Tree *h)
+{
+	switch (h->type) {
+#define STMT(id, ...) case STMT_##id: CHILDREN(Stmt##id, ## __VA_ARGS__) break;
+#define EXPR(id, ...) case EXPR_##id: CHILDREN(Expr##id, ## __VA_ARGS__) break;
+#define TYPE(id, ...) case TYPE_##id: CHILDREN(Type##id, ## __VA_ARGS__) break;
+#include "tree_nodes.def"
+#undef STMT
+#undef EXPR
+#undef TYPE
+	case STMT_BLOCK:
+	case STMT_DECLS: {
+		StmtBLOCK *s = (StmtBLOCK *) h;
+		for (int i = s->items.length - 1; i >= 0; i--)
+			push_child(pm, s->items.data[i], mask);
+		break;
+	}
+	case STMT_ASM: {
+		StmtASM *s = (StmtASM *) h;
+		for (int i = s->inputs.length - 1; i >= 0; i--)
+			push_child(pm, s->inputs.data[i].variable, mask);
+		for (int i = s->outputs.length - 1; i >= 0; i--)
+			push_child(pm, s->outputs.data[i].variable, mask);
+		break;
+	}
+	case STMT_SKIM:
+	case STMT_LAZY:
+	case EXPR_INITPACK:
+		break;
+	case EXPR_CALL: {
+		ExprCALL *e = (ExprCALL *) h;
+		for (int i = e->args.length - 1; i >= 0; i--)
+			push_child(pm, e->args.data[i], mask);
+		push_child(pm, e->func, mask);
+		break;
+	}
+	case EXPR_INIT: {
+		ExprINIT *e = (ExprINIT *) h;
+		for (int i = e->items.length - 1; i >= 0; i--) {
+			push_child(pm, e->items.data[i].value, mask);
+			push_designators(pm, mask, e->items.data[i].designator);
+		}
+		break;
+	}
+	case EXPR_GENERIC: {
+		ExprGENERIC *e = (ExprGENERIC *) h;
+		for (int i = e->items.length - 1; i >= 0; i--) {
+			push_child(pm, e->items.data[i].expr, mask);
+			if (e->items.data[i].type)
+				push_child(pm, e->items.data[i].type, mask);
+		}
+		push_child(pm, e->expr, mask);
+		break;
+	}
+	case TYPE_FUN: {
+		TypeFUN *t = (TypeFUN *) h;
+		for (int i = t->at.length - 1; i >= 0; i--)
+			push_child(pm, t->at.data[i], mask);
+		push_child(pm, t->rt, mask);
+		break;
+	}
+	default:
+		assert(0);
+	}
+}
+
+bool visit(Visitor *v, Tree *h)
+{
+	PassManager pm;
+	passes_init(&pm);
+	passes_add(&pm, v);
+	unsigned stopped = passes_run(&pm, h);
+	passes_deinit(&pm);
+	return !stopped;
+}
+
+void passes_init(PassManager *pm)
+{
+	pm->npasses = 0;
+	for (int i = 0; i < VISIT_KINDS; i++) {
+		pm->pre[i] = 0;
+		pm->post[i] = 0;
+	}
+	pm->attr = 0;
+	vec_init(&pm->stack);
+}
+
+void passes_deinit(PassManager *pm)
+{
+	vec_deinit(&pm->stack);
+}
+
+void passes_add(PassManager *pm, Visitor *v)
+{
+	assert(pm->npasses < PASSES_MAX);
+	unsigned bit = 1u << pm->npasses;
+	pm->passes[pm->npasses++] = v;
+	for (int i = 0; i < VISIT_KINDS; i++) {
+		if (pre_hook(v, i))
+			pm->pre[i] |= bit;
+		if (post_hook(v, i))
+			pm->post[i] |= bit;
+	}
+	if (v->attr)
+		pm->attr |= bit;
+}
+
+unsigned passes_run(PassManager *pm, Tree *h)
+{
+	unsigned all = (1u << pm->npasses) - 1;
+	pm->live = all;
+	if (h && all)
+		push(pm, h, all, false);
+	while (pm->stack.length && pm->live) {
+		VisitFrame f = pm->stack.data[--pm->stack.length];
+		unsigned mask = f.mask & pm->live;
+		Tree *n = f.node;
+		int kind = n->type;
+		unsigned m;
+		if (!mask)
+			continue;
+		if (f.post) {
+			for (m = mask; m; m &= m - 1) {
+				Visitor *v = pm->passes[__builtin_ctz(m)];
+				post_hook(v, kind)(v, n);
+			}
+			continue;
+		}
+		// passes without a pre hook always descend
+		unsigned down = mask & ~pm->pre[kind];
+		for (m = mask & pm->pre[kind]; m; m &= m - 1) {
+			unsigned bit = m & -m;
+			Visitor *v = pm->passes[__builtin_ctz(m)];
+			switch (pre_hook(v, kind)(v, n)) {
+			case VISIT_CONTINUE:
+				down |= bit;
+				break;
+			case VISIT_STOP:
+				pm->live &= ~bit;
+				break;
+			}
+		}
+		unsigned post = mask & pm->post[kind] & pm->live;
+		if (post)
+			push(pm, n, post, true);
+		down &= pm->live;
+		if (down && !node_leaf[kind])
+			push_children(pm, down, n);
+	}
+	pm->stack.length = 0;
+	return all & ~pm->live;
+}
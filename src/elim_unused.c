@@ -1,429 +1,222 @@
 #include <cast/parser.h>
 #include <cast/map.h>
+#include <cast/visit.h>
 
 #include <cast/printer.h>
 
 #include <stdio.h>
-
-BEGIN_MANAGED
+#include <stdlib.h>
+#include <string.h>
 
 typedef struct {
 	bool progress;
 	map_int_t symbol_set;
+	/* the declarations already marked in full, by their order in the
+	   unit, which both passes walk the same way; marking one again
+	   finds nothing new */
+	vec_char_t done;
+	int item;
+	Visitor marker;
+	PassManager passes;
 } State;
 
-static void mark_expr(State *st, Expr *h);
-static void mark_stmt(State *st, Stmt *h);
-static void mark_type(State *st, Type *type);
+static void mark_name(State *st, const char *name)
+{
+	st->progress = st->progress ||
+		map_get(&st->symbol_set, name) == NULL;
+	map_set(&st->symbol_set, name, 1);
+}
 
-static void mark_attrs(State *st, Attribute *attrs)
+static bool is_alias(Attribute *a)
 {
-	for (Attribute *a = attrs; a; a = a->next) {
-		if (strcmp(a->name, "__alias__") == 0 ||
-		    strcmp(a->name, "alias") == 0) {
-			Expr *p;
-			int i;
-			avec_foreach(&a->args, p, i) {
-				if (p->type == EXPR_STRING_CST) {
-					ExprSTRING_CST *s = (ExprSTRING_CST *) p;
-					map_set(&st->symbol_set, s->v, 1);
-				} else {
-					fprintf(stderr,
-						"elim_unused: bad alias\n");
-				}
-			}
-		} else if (a->args.length) {
-			Expr *p;
-			int i;
-			avec_foreach(&a->args, p, i) {
-				mark_expr(st, p);
-			}
-		}
-	}
+	return strcmp(a->name, "__alias__") == 0 ||
+		strcmp(a->name, "alias") == 0;
 }
 
-static void mark_type(State *st, Type *type)
+static void mark_alias(State *st, Attribute *a)
 {
-	switch(type->type) {
-	case TYPE_PTR:
-		mark_type(st, ((TypePTR *) type)->t);
-		break;
-	case TYPE_ARRAY:
-		mark_type(st, ((TypeARRAY *) type)->t);
-		if (((TypeARRAY *) type)->n)
-			mark_expr(st, ((TypeARRAY *) type)->n);
-		break;
-	case TYPE_FUN: {
-		Type *p;
-		int i;
-		vec_foreach(&((TypeFUN *) type)->at, p, i) {
-			mark_type(st, p);
-		}
-		mark_type(st, ((TypeFUN *) type)->rt);
-		break;
-	}
-	case TYPE_TYPEDEF: {
-		TypeTYPEDEF *t = (TypeTYPEDEF *) type;
-		st->progress = st->progress ||
-			map_get(&st->symbol_set, t->name) == NULL;
-		map_set(&st->symbol_set, t->name, 1);
-		break;
-	}
-	case TYPE_STRUCT: {
-		TypeSTRUCT *t = (TypeSTRUCT *) type;
-		if (t->tag) {
-			st->progress = st->progress ||
-				map_get(&st->symbol_set, t->tag) == NULL;
-			map_set(&st->symbol_set, t->tag, 1);
-		}
-		if (t->decls) {
-			mark_stmt(st, (Stmt *) t->decls);
+	Expr *p;
+	int i;
+	avec_foreach(&a->args, p, i) {
+		if (p->type == EXPR_STRING_CST) {
+			ExprSTRING_CST *s = (ExprSTRING_CST *) p;
+			char name[s->len];
+			memcpy(name, s->v, s->len - 1);
+			name[s->len - 1] = 0;
+			map_set(&st->symbol_set, name, 1);
+		} else {
+			fprintf(stderr,
+				"elim_unused: bad alias\n");
 		}
-		if (t->attrs)
-			mark_attrs(st, t->attrs);
-		break;
-	}
-	case TYPE_ENUM: {
-		TypeENUM *t = (TypeENUM *) type;
-		if (t->tag) {
-			st->progress = st->progress ||
-				map_get(&st->symbol_set, t->tag) == NULL;
-			map_set(&st->symbol_set, t->tag, 1);
-		}
-		if (t->list) {
-			struct EnumPair_ *p;
-			int i;
-			vec_foreach_ptr(&(t->list->items), p, i) {
-				if (p->val) {
-					mark_expr(st, p->val);
-				}
-			}
-		}
-		if (t->attrs)
-			mark_attrs(st, t->attrs);
-		break;
-	}
-	case TYPE_TYPEOF: {
-		TypeTYPEOF *t = (TypeTYPEOF *) type;
-		mark_expr(st, t->e);
-		break;
-	}
-	case TYPE_TYPEOFUNQUAL: {
-		TypeTYPEOFUNQUAL *t = (TypeTYPEOFUNQUAL *) type;
-		mark_expr(st, t->e);
-		break;
-	}
-	case TYPE_AUTO:
-		break;
 	}
 }
 
-static void mark_expr(State *st, Expr *h)
+static int mark_ident(Visitor *v, Expr *h)
 {
-	switch (h->type) {
-	case EXPR_IDENT: {
-		ExprIDENT *e = (ExprIDENT *) h;
-		st->progress = st->progress ||
-			map_get(&st->symbol_set, e->id) == NULL;
-		map_set(&st->symbol_set, e->id, 1);
-		break;
-	}
-	case EXPR_MEM: {
-		ExprMEM *e = (ExprMEM *) h;
-		mark_expr(st, e->a);
-		break;
-	}
-	case EXPR_PMEM: {
-		ExprPMEM *e = (ExprPMEM *) h;
-		mark_expr(st, e->a);
-		break;
-	}
-	case EXPR_CALL: {
-		ExprCALL *e = (ExprCALL *) h;
-		mark_expr(st, e->func);
-		Expr *p;
-		int i;
-		vec_foreach(&e->args, p, i) {
-			mark_expr(st, p);
-		}
-		break;
-	}
-	case EXPR_BOP: {
-		ExprBOP *e = (ExprBOP *) h;
-		mark_expr(st, e->a);
-		mark_expr(st, e->b);
-		break;
-	}
-	case EXPR_UOP: {
-		ExprUOP *e = (ExprUOP *) h;
-		mark_expr(st, e->e);
-		break;
-	}
-	case EXPR_COND: {
-		ExprCOND *e = (ExprCOND *) h;
-		mark_expr(st, e->c);
-		if (e->a) mark_expr(st, e->a);
-		mark_expr(st, e->b);
-		break;
-	}
-	case EXPR_CAST: {
-		ExprCAST *e = (ExprCAST *) h;
-		mark_type(st, e->t);
-		mark_expr(st, e->e);
-		break;
-	}
-	case EXPR_SIZEOF: {
-		ExprSIZEOF *e = (ExprSIZEOF *) h;
-		mark_expr(st, e->e);
-		break;
-	}
-	case EXPR_SIZEOFT: {
-		ExprSIZEOFT *e = (ExprSIZEOFT *) h;
-		mark_type(st, e->t);
-		break;
-	}
-	case EXPR_ALIGNOF: {
-		ExprALIGNOF *e = (ExprALIGNOF *) h;
-		mark_type(st, e->t);
-		break;
-	}
-	case EXPR_INIT: {
-		ExprINIT *e = (ExprINIT *) h;
-		ExprINITItem p;
-		int i;
-		vec_foreach(&e->items, p, i) {
-			for (Designator *des = p.designator;
-			     des; des = des->next) {
-				switch (des->type) {
-				case DES_FIELD:
-					break;
-				case DES_INDEX:
-					mark_expr(st, des->index);
-					break;
-				case DES_INDEXRANGE:
-					mark_expr(st, des->index);
-					mark_expr(st, des->indexhigh);
-					break;
-				}
-			}
-			mark_expr(st, p.value);
-		}
-		break;
-	}
-	case EXPR_VASTART: {
-		ExprVASTART *e = (ExprVASTART *) h;
-		mark_expr(st, e->ap);
-		break;
-	}
-	case EXPR_VAARG: {
-		ExprVAARG *e = (ExprVAARG *) h;
-		mark_expr(st, e->ap);
-		mark_type(st, e->type);
-		break;
-	}
-	case EXPR_VAEND: {
-		ExprVAEND *e = (ExprVAEND *) h;
-		mark_expr(st, e->ap);
-		break;
-	}
-	case EXPR_OFFSETOF: {
-		ExprOFFSETOF *e = (ExprOFFSETOF *) h;
-		mark_type(st, e->type);
-		break;
-	}
-	case EXPR_STMT: {
-		ExprSTMT *e = (ExprSTMT *) h;
-		mark_stmt(st, (Stmt *) e->s);
-		break;
-	}
-	case EXPR_GENERIC: {
-		ExprGENERIC *e = (ExprGENERIC *) h;
-		mark_expr(st, e->expr);
-		GENERICPair *item;
-		int i;
-		avec_foreach_ptr(&e->items, item, i) {
-			if (item->type)
-				mark_type(st, item->type);
-			mark_expr(st, item->expr);
-		}
-		break;
-	}
-	case EXPR_TYPESCOMPATIBLE: {
-		ExprTYPESCOMPATIBLE *e = (ExprTYPESCOMPATIBLE *) h;
-		mark_expr(st, e->type1);
-		mark_expr(st, e->type2);
-		break;
-	}
-	case EXPR_TYPENAME: {
-		ExprTYPENAME *e = (ExprTYPENAME *) h;
-		mark_expr(st, e->type);
-		break;
-	}
-	}
+	mark_name(v->data, ((ExprIDENT *) h)->id);
+	return VISIT_CONTINUE;
 }
 
-static void mark_stmt(State *st, Stmt *h)
+static int mark_typedef(Visitor *v, Type *h)
 {
-	switch (h->type) {
-	case STMT_EXPR: {
-		StmtEXPR *s = (StmtEXPR *) h;
-		mark_expr(st, s->expr);
-		break;
-	}
-	case STMT_IF: {
-		StmtIF *s = (StmtIF *) h;
-		mark_expr(st, s->cond);
-		mark_stmt(st, s->body1);
-		if (s->body2) {
-			mark_stmt(st, s->body2);
-		}
-		break;
-	}
-	case STMT_WHILE: {
-		StmtWHILE *s = (StmtWHILE *) h;
-		mark_expr(st, s->cond);
-		mark_stmt(st, s->body);
-		break;
-	}
-	case STMT_DO: {
-		StmtDO *s = (StmtDO *) h;
-		mark_stmt(st, s->body);
-		mark_expr(st, s->cond);
-		break;
-	}
-	case STMT_FOR: {
-		StmtFOR *s = (StmtFOR *) h;
-		if (s->init) mark_expr(st, s->init);
-		if (s->cond) mark_expr(st, s->cond);
-		if (s->step) mark_expr(st, s->step);
-		mark_stmt(st, s->body);
-		break;
-	}
-	case STMT_FOR99: {
-		StmtFOR99 *s = (StmtFOR99 *) h;
-		mark_stmt(st, (Stmt *) s->init);
-		if (s->cond) mark_expr(st, s->cond);
-		if (s->step) mark_expr(st, s->step);
-		mark_stmt(st, s->body);
-		break;
-	}
-	case STMT_BREAK: break;
-	case STMT_CONTINUE: break;
-	case STMT_SWITCH: {
-		StmtSWITCH *s = (StmtSWITCH *) h;
-		mark_expr(st, s->expr);
-		mark_stmt(st, s->body);
-		break;
-	}
-	case STMT_CASE: {
-		StmtCASE *s = (StmtCASE *) h;
-		mark_expr(st, s->expr);
-		mark_stmt(st, s->stmt);
-		break;
-	}
-	case STMT_DEFAULT: {
-		StmtDEFAULT *s = (StmtDEFAULT *) h;
-		mark_stmt(st, s->stmt);
-		break;
-	}
-	case STMT_LABEL: {
-		StmtLABEL *s = (StmtLABEL *) h;
-		mark_stmt(st, s->stmt);
-		break;
-	}
-	case STMT_GOTO: break;
-	case STMT_RETURN: {
-		StmtRETURN *s = (StmtRETURN *) h;
-		if (s->expr) {
-			mark_expr(st, s->expr);
-		}
-		break;
-	}
-	case STMT_SKIP: {
-		StmtSKIP *s = (StmtSKIP *) h;
-		if (s->attrs)
-			mark_attrs(st, s->attrs);
-		break;
-	}
-	case STMT_BLOCK: {
-		StmtBLOCK *s = (StmtBLOCK *) h;
-		Stmt *p;
-		int i;
-		vec_foreach(&s->items, p, i) {
-			mark_stmt(st, p);
-		}
-		break;
-	}
-	case STMT_FUNDECL: {
-		StmtFUNDECL *s = (StmtFUNDECL *) h;
-		mark_type(st, (Type *) &s->type);
-		if (s->body) {
-			mark_stmt(st, (Stmt *) &s->body);
-		}
-		if (s->ext.gcc_attribute)
-			mark_attrs(st, s->ext.gcc_attribute);
-		break;
-	}
-	case STMT_VARDECL: {
-		StmtVARDECL *s = (StmtVARDECL *) h;
-		mark_type(st, s->type);
-		if (s->init) {
-			mark_expr(st, s->init);
-		}
-		if (s->ext.gcc_attribute)
-			mark_attrs(st, s->ext.gcc_attribute);
-		break;
-	}
-	case STMT_TYPEDEF: {
-		StmtTYPEDEF *s = (StmtTYPEDEF *) h;
-		mark_type(st, s->type);
-		if (s->ext.gcc_attribute)
-			mark_attrs(st, s->ext.gcc_attribute);
-		break;
-	}
-	case STMT_DECLS: {
-		StmtDECLS *s = (StmtDECLS *) h;
-		Stmt *p;
-		int i;
-		vec_foreach(&s->items, p, i) {
-			mark_stmt(st, p);
-		}
-		break;
-	}
-	case STMT_GOTOADDR: {
-		StmtGOTOADDR *s = (StmtGOTOADDR *) h;
-		mark_expr(st, s->expr);
-		break;
+	mark_name(v->data, ((TypeTYPEDEF *) h)->name);
+	return VISIT_CONTINUE;
+}
+
+static int mark_struct(Visitor *v, Type *h)
+{
+	if (((TypeSTRUCT *) h)->tag)
+		mark_name(v->data, ((TypeSTRUCT *) h)->tag);
+	return VISIT_CONTINUE;
+}
+
+static int mark_enum(Visitor *v, Type *h)
+{
+	if (((TypeENUM *) h)->tag)
+		mark_name(v->data, ((TypeENUM *) h)->tag);
+	return VISIT_CONTINUE;
+}
+
+// the member designator names fields, not symbols
+static int mark_offsetof(Visitor *v, Expr *h)
+{
+	visit(v, ((ExprOFFSETOF *) h)->type);
+	return VISIT_SKIP;
+}
+
+static bool is_idchar(char c)
+{
+	return c == '_' || c == '$' || (unsigned char) c >= 0x80 ||
+		(c >= '0' && c <= '9') ||
+		((c | 0x20) >= 'a' && (c | 0x20) <= 'z');
+}
+
+// unparsed text may use any name it spells
+static int mark_opaque(Visitor *v, Stmt *h)
+{
+	StmtOPAQUE *s = (StmtOPAQUE *) h;
+	const char *q = s->text, *end = q + s->len;
+	while (q < end) {
+		const char *b = q;
+		while (q < end && is_idchar(*q))
+			q++;
+		if (q == b) {
+			q++;
+			continue;
+		}
+		if (*b >= '0' && *b <= '9')
+			continue;
+		int n = q - b;
+		char buf[256], *name = n < (int) sizeof(buf) ? buf : malloc(n + 1);
+		memcpy(name, b, n);
+		name[n] = 0;
+		mark_name(v->data, name);
+		if (name != buf)
+			free(name);
+	}
+	return VISIT_CONTINUE;
+}
+
+static int mark_skim(Visitor *v, Stmt *h)
+{
+	StmtSKIM *s = (StmtSKIM *) h;
+	const char *name;
+	int i;
+	avec_foreach(&s->uses, name, i) {
+		mark_name(v->data, name);
 	}
-	case STMT_LABELDECL: break;
-	case STMT_CASERANGE: {
-		StmtCASERANGE *s = (StmtCASERANGE *) h;
-		mark_expr(st, s->low);
-		mark_expr(st, s->high);
-		mark_stmt(st, s->stmt);
-		break;
+	return VISIT_CONTINUE;
+}
+
+// an unparsed body uses the identifiers in it
+static int mark_lazy(Visitor *v, Stmt *h)
+{
+	StmtLAZY *s = (StmtLAZY *) h;
+	const char *name;
+	int i;
+	avec_foreach(&s->uses, name, i) {
+		mark_name(v->data, name);
 	}
-	case STMT_ASM: {
-		int i;
-		StmtASM *s = (StmtASM *) h;
-		ASMOper *oper;
-		avec_foreach_ptr(&s->outputs, oper, i) {
-			mark_expr(st, oper->variable);
-		}
-		avec_foreach_ptr(&s->inputs, oper, i) {
-			mark_expr(st, oper->variable);
+	return VISIT_CONTINUE;
+}
+
+static int mark_attr(Visitor *v, Attribute *a)
+{
+	if (!is_alias(a))
+		return VISIT_CONTINUE;
+	mark_alias(v->data, a);
+	return VISIT_SKIP;
+}
+
+static void state_init(State *st)
+{
+	st->progress = false;
+	map_init(&st->symbol_set);
+	vec_init(&st->done);
+	st->item = 0;
+	st->marker = (Visitor) {
+		.pre[EXPR_IDENT] = mark_ident,
+		.pre[EXPR_OFFSETOF] = mark_offsetof,
+		.pre[STMT_OPAQUE] = mark_opaque,
+		.pre[STMT_SKIM] = mark_skim,
+		.pre[STMT_LAZY] = mark_lazy,
+		.pre[TYPE_TYPEDEF] = mark_typedef,
+		.pre[TYPE_STRUCT] = mark_struct,
+		.pre[TYPE_ENUM] = mark_enum,
+		.attr = mark_attr,
+		.data = st,
+	};
+	passes_init(&st->passes);
+	passes_add(&st->passes, &st->marker);
+}
+
+static void state_deinit(State *st)
+{
+	passes_deinit(&st->passes);
+	vec_deinit(&st->done);
+	map_deinit(&st->symbol_set);
+}
+
+// marks the symbols used by a subtree
+static void mark(State *st, Tree *h)
+{
+	passes_run(&st->passes, h);
+}
+
+// the index of the next declaration in st->done
+static int next_item(State *st)
+{
+	if (st->item == st->done.length)
+		vec_push(&st->done, false);
+	return st->item++;
+}
+
+// marks all the declaration k may use
+static void mark_item(State *st, int k, Tree *h)
+{
+	mark(st, h);
+	st->done.data[k] = true;
+}
+
+static void mark_attrs(State *st, Attribute *attrs)
+{
+	for (Attribute *a = attrs; a; a = a->next) {
+		if (is_alias(a)) {
+			mark_alias(st, a);
+		} else {
+			Expr *p;
+			int i;
+			avec_foreach(&a->args, p, i) {
+				mark(st, p);
+			}
 		}
-		break;
-	}
-	case STMT_STATICASSERT: {
-		StmtSTATICASSERT *s = (StmtSTATICASSERT *) h;
-		mark_expr(st, s->expr);
-		break;
-	}
 	}
 }
 
-static bool attr_is_good(Attribute *attr)
+BEGIN_MANAGED
+
+// attributes that don't keep an unused declaration
+static bool attr_name_is_good(const char *name)
 {
 	static const char *goodattrs[] = {
 		"__access__", "__alloc_align__", "__alloc_size__",
@@ -433,22 +226,67 @@ static bool attr_is_good(Attribute *attr)
 		"__warn_unused_result__",
 		NULL
 	};
+	for (const char **key = goodattrs; *key; key++) {
+		if (strcmp(name, *key) == 0)
+			return true;
+	}
+	return false;
+}
+
+static bool attr_is_good(Attribute *attr)
+{
 	for (; attr; attr = attr->next) {
-		bool matched = false;
-		for (const char **key = goodattrs; *key; key++) {
-			if (strcmp(attr->name, *key) == 0) {
-				matched = true;
-				break;
-			}
-		}
-		if (!matched)
+		if (!attr_name_is_good(attr->name))
 			return false;
 	}
 	return true;
 }
 
+// the same choice as for parsed declarations, from the skimmed facts
+static bool skim_is_root(StmtSKIM *s)
+{
+	if (!s->defs.length)
+		return true;
+	if (s->flags & SKIM_TYPEDEF)
+		return false;
+	if ((s->flags & SKIM_BODY) && !(s->flags & SKIM_STATIC))
+		return true;
+	if ((s->flags & SKIM_VAR) && !(s->flags & SKIM_EXTERN))
+		return true;
+	const char *name;
+	int i;
+	avec_foreach(&s->attrs, name, i) {
+		if ((s->flags & SKIM_FUN) && !attr_name_is_good(name))
+			return true;
+		if ((s->flags & SKIM_VAR) && strcmp(name, "unused") == 0)
+			return true;
+	}
+	return false;
+}
+
+static bool skim_is_used(State *st, StmtSKIM *s)
+{
+	const char *name;
+	int i;
+	avec_foreach(&s->defs, name, i) {
+		if (map_get(&st->symbol_set, name))
+			return true;
+	}
+	return false;
+}
+
 static void mark_topstmt(State *st, Stmt *h)
 {
+	if (h->type == STMT_DECLS) {
+		StmtDECLS *s = (StmtDECLS *) h;
+		Stmt *p;
+		int i;
+		vec_foreach(&s->items, p, i) {
+			mark_topstmt(st, p);
+		}
+		return;
+	}
+	int k = next_item(st);
 	switch (h->type) {
 	case STMT_FUNDECL: {
 		StmtFUNDECL *s = (StmtFUNDECL *) h;
@@ -456,11 +294,7 @@ static void mark_topstmt(State *st, Stmt *h)
 		    !attr_is_good(s->ext.gcc_attribute)) {
 			if (s->name)
 				map_set(&st->symbol_set, s->name, 1);
-			mark_type(st, (Type *) s->type);
-			if (s->body)
-				mark_stmt(st, (Stmt *) s->body);
-			if (s->ext.gcc_attribute)
-				mark_attrs(st, s->ext.gcc_attribute);
+			mark_item(st, k, h);
 		}
 		break;
 	}
@@ -468,11 +302,7 @@ static void mark_topstmt(State *st, Stmt *h)
 		StmtVARDECL *s = (StmtVARDECL *) h;
 		if (!(s->flags & DFLAG_EXTERN) && s->name) {
 			map_set(&st->symbol_set, s->name, 1);
-			mark_type(st, s->type);
-			if (s->init)
-				mark_expr(st, s->init);
-			if (s->ext.gcc_attribute)
-				mark_attrs(st, s->ext.gcc_attribute);
+			mark_item(st, k, h);
 		} else if ((s->flags & DFLAG_EXTERN) && s->name) {
 			Attribute *attr = s->ext.gcc_attribute;
 			while (attr) {
@@ -486,19 +316,23 @@ static void mark_topstmt(State *st, Stmt *h)
 		}
 		break;
 	}
-	case STMT_DECLS: {
-		StmtDECLS *s = (StmtDECLS *) h;
-		Stmt *p;
-		int i;
-		vec_foreach(&s->items, p, i) {
-			mark_topstmt(st, p);
-		}
-		break;
-	}
 	case STMT_ASM:
 	case STMT_STATICASSERT:
-		mark_stmt(st, h);
+	case STMT_OPAQUE:
+		mark(st, h);
 		break;
+	case STMT_SKIM: {
+		StmtSKIM *s = (StmtSKIM *) h;
+		if (skim_is_root(s)) {
+			const char *name;
+			int i;
+			avec_foreach(&s->defs, name, i) {
+				map_set(&st->symbol_set, name, 1);
+			}
+			mark_item(st, k, h);
+		}
+		break;
+	}
 	}
 }
 
@@ -561,17 +395,28 @@ static bool check_nested(Stmt *p)
 
 static void mark_topstmt2(State *st, Stmt *h)
 {
+	if (h->type == STMT_DECLS) {
+		StmtDECLS *s = (StmtDECLS *) h;
+		Stmt *p;
+		int i;
+		vec_foreach(&s->items, p, i) {
+			mark_topstmt2(st, p);
+		}
+		return;
+	}
+	int k = next_item(st);
+	if (st->done.data[k])
+		return;
 	switch (h->type) {
+	case STMT_SKIM:
+		if (skim_is_used(st, (StmtSKIM *) h))
+			mark_item(st, k, h);
+		break;
 	case STMT_FUNDECL: {
 		StmtFUNDECL *s = (StmtFUNDECL *) h;
 		if (s->name) {
-			if (map_get(&st->symbol_set, s->name)) {
-				mark_type(st, (Type *) s->type);
-				if (s->body)
-					mark_stmt(st, (Stmt *) s->body);
-				if (s->ext.gcc_attribute)
-					mark_attrs(st, s->ext.gcc_attribute);
-			}
+			if (map_get(&st->symbol_set, s->name))
+				mark_item(st, k, h);
 		}
 		break;
 	}
@@ -579,20 +424,20 @@ static void mark_topstmt2(State *st, Stmt *h)
 		StmtVARDECL *s = (StmtVARDECL *) h;
 		if (s->name) {
 			if (map_get(&st->symbol_set, s->name)) {
-				mark_type(st, s->type);
+				mark_item(st, k, s->type);
 			}
 		}
 		if (s->type->type == TYPE_STRUCT) {
 			TypeSTRUCT *t = (TypeSTRUCT *) s->type;
 			if (t->tag && map_get(&st->symbol_set, t->tag)) {
-				mark_type(st, s->type);
+				mark_item(st, k, s->type);
 			} else if (t->decls) {
 				// has nested struct/enum defs?
 				Stmt *p;
 				int i;
 				avec_foreach(&(t->decls->items), p, i) {
 					if (check_nested(p)) {
-						mark_type(st, s->type);
+						mark_item(st, k, s->type);
 						break;
 					}
 				}
@@ -600,13 +445,13 @@ static void mark_topstmt2(State *st, Stmt *h)
 		} else if (s->type->type == TYPE_ENUM) {
 			TypeENUM *t = (TypeENUM *) s->type;
 			if (t->tag && map_get(&st->symbol_set, t->tag)) {
-				mark_type(st, s->type);
+				mark_item(st, k, s->type);
 			} else if (t->list) {
 				struct EnumPair_ *p;
 				int i;
 				avec_foreach_ptr(&(t->list->items), p, i) {
 					if (map_get(&st->symbol_set, p->id)) {
-						mark_type(st, s->type);
+						mark_item(st, k, s->type);
 						break;
 					}
 				}
@@ -618,39 +463,36 @@ static void mark_topstmt2(State *st, Stmt *h)
 		StmtTYPEDEF *s = (StmtTYPEDEF *) h;
 		if (s->name) {
 			if (map_get(&st->symbol_set, s->name)) {
-				mark_type(st, s->type);
+				mark_item(st, k, s->type);
 			}
 		}
 		if (s->type->type == TYPE_STRUCT) {
 			TypeSTRUCT *t = (TypeSTRUCT *) s->type;
 			if (t->tag) {
 				if (map_get(&st->symbol_set, t->tag)) {
-					mark_type(st, s->type);
+					mark_item(st, k, s->type);
 				}
 			}
 		} else if (s->type->type == TYPE_ENUM) {
 			TypeENUM *t = (TypeENUM *) s->type;
 			if (t->tag && map_get(&st->symbol_set, t->tag)) {
-				mark_type(st, s->type);
+				mark_item(st, k, s->type);
 			}
 		}
 		break;
 	}
-	case STMT_DECLS: {
-		StmtDECLS *s = (StmtDECLS *) h;
-		Stmt *p;
-		int i;
-		vec_foreach(&s->items, p, i) {
-			mark_topstmt2(st, p);
-		}
-		break;
-	}
 	}
 }
 
 static void sweep_topstmt(State *st, Stmt *h, StmtBLOCK *n)
 {
 	switch (h->type) {
+	case STMT_SKIM: {
+		StmtSKIM *s = (StmtSKIM *) h;
+		if (!s->defs.length || skim_is_used(st, s))
+			stmtBLOCK_append(n, h);
+		break;
+	}
 	case STMT_FUNDECL: {
 		StmtFUNDECL *s = (StmtFUNDECL *) h;
 		if (s->name && map_get(&st->symbol_set, s->name)) {
@@ -760,8 +602,7 @@ static void sweep_topstmt(State *st, Stmt *h, StmtBLOCK *n)
 StmtBLOCK *elim_unused(StmtBLOCK *tu)
 {
 	State *st = __new(State);
-	st->progress = false;
-	map_init(&st->symbol_set);
+	state_init(st);
 
 	StmtBLOCK *res = stmtBLOCK();
 	Stmt *p;
@@ -773,6 +614,7 @@ StmtBLOCK *elim_unused(StmtBLOCK *tu)
 
 	do {
 		st->progress = false;
+		st->item = 0;
 		vec_foreach(&tu->items, p, i) {
 			mark_topstmt2(st, p);
 		}
@@ -782,7 +624,7 @@ StmtBLOCK *elim_unused(StmtBLOCK *tu)
 		sweep_topstmt(st, p, res);
 	}
 
-	map_deinit(&st->symbol_set);
+	state_deinit(st);
 	return res;
 }
 
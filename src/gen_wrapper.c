@@ -199,11 +199,11 @@ static int main1(const char *file, const char *namefile)
 	}
 
 	int ret = 0;
+	Allocator *a = allocator_new();
 	TextStream *ts = text_stream_new(file);
-	Lexer *l = lexer_new(ts);
-	Parser *p = parser_new(l);
+	Lexer *l = lexer_new(ts, a);
+	Parser *p = parser_new(l, a);
 
-	Allocator *a = allocator_new();
 	Context *ctx = context_new(a);
 	StmtBLOCK *translation_unit = CALL_MANAGED(parse_translation_unit, ctx, p);
 	if (translation_unit) {
@@ -4,6 +4,7 @@ CSRCS = gen_wrapper.c
 OBJS += ${TOPDIR}/lib/libcast.a
 
 CFLAGS = -I ${TOPDIR} -I ${TOPDIR}/include -Os
+LDFLAGS = -lpthread
 
 include ${TOPDIR}/make/comm.mk
 include ${TOPDIR}/make/c.mk
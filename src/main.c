@@ -5,11 +5,21 @@
 #include <cast/lexer.h>
 #include <cast/parser.h>
 #include <cast/printer.h>
+#include <cast/srcloc.h>
 #include <cast/map.h>
+#include <cast/visit.h>
+
+#include "stats.h"
 
 typedef struct {
 	map_int_t managed_symbols;
 	int managed_count;
+	// a managed body did not parse, so its calls can't be rewritten
+	bool failed;
+	Context *ctx;
+	Parser *parser;
+	Visitor decls, calls;
+	PassManager passes;
 } Patch;
 
 #include <string.h>
@@ -25,382 +35,524 @@ static char *addprefix(const char *old)
 	return newname;
 }
 
-static void patch_decl(Patch *ctx, Stmt *h)
+static void patch_fundecl(StmtFUNDECL *s)
+{
+	s->name = addprefix(s->name);
+	Type *t = typePTR(typeTYPEDEF("Context", 0), 0);
+	typeFUN_prepend(s->type, t);
+	if (s->args == NULL) {
+		s->args = stmtBLOCK();
+	}
+	stmtBLOCK_prepend(
+		s->args,
+		stmtVARDECL(0, "__myctx", t, NULL, NULL,
+			    (Extension) {}));
+}
+
+static void patch_callexpr(Patch *ctx, ExprCALL *e)
 {
-	switch (h->type) {
-	case STMT_FUNDECL: {
-		StmtFUNDECL *s = (StmtFUNDECL *) h;
-		if (s->name && (s->flags & DFLAG_MANAGED)) {
-			map_set(&ctx->managed_symbols, s->name, 1);
-			s->name = addprefix(s->name);
-			Type *t = typePTR(typeTYPEDEF("Context", 0), 0);
-			typeFUN_prepend(s->type, t);
-			if (s->args == NULL) {
-				s->args = stmtBLOCK();
-			}
-			stmtBLOCK_prepend(
-				s->args,
-				stmtVARDECL(0, "__myctx", t, NULL, NULL,
-					    (Extension) {}));
+	if (e->func->type == EXPR_IDENT) {
+		ExprIDENT *i = (ExprIDENT *) e->func;
+		if (map_get(&ctx->managed_symbols, i->id)) {
+			i->id = addprefix(i->id);
+			exprCALL_prepend(
+				e,
+				exprIDENT("__myctx"));
+		} else if (strcmp(i->id, "__new_") == 0) {
+			e->func = exprIDENT("allocator_memalloc");
+			exprCALL_prepend(e,
+					 exprPMEM(exprIDENT("__myctx"),
+						  "allocator"));
 		}
-		break;
 	}
-	case STMT_DECLS: {
+}
+END_MANAGED
+
+static bool is_managed_fundecl(Stmt *h)
+{
+	return h->type == STMT_FUNDECL &&
+		((StmtFUNDECL *) h)->name &&
+		(((StmtFUNDECL *) h)->flags & DFLAG_MANAGED);
+}
+
+// collect the managed functions declared at top level
+static void patch_scan(Patch *ctx, Stmt *h)
+{
+	if (is_managed_fundecl(h)) {
+		map_set(&ctx->managed_symbols, ((StmtFUNDECL *) h)->name, 1);
+	} else if (h->type == STMT_DECLS) {
 		StmtDECLS *s = (StmtDECLS *) h;
 		int i;
 		Stmt *s1;
 		avec_foreach(&s->items, s1, i) {
-			patch_decl(ctx, s1);
+			patch_scan(ctx, s1);
 		}
-		break;
-	}
-	default:
-		break;
 	}
 }
 
-static void patch_call1_expr(Patch *ctx, Expr *h)
+// adds the context parameter to managed functions at top level
+static int patch_decls_fundecl(Visitor *v, Stmt *h)
 {
-	switch (h->type) {
-	case EXPR_IDENT: {
-		ExprIDENT *e = (ExprIDENT *) h;
-		break;
-	}
-	case EXPR_MEM: {
-		ExprMEM *e = (ExprMEM *) h;
-		patch_call1_expr(ctx, e->a);
-		break;
-	}
-	case EXPR_PMEM: {
-		ExprPMEM *e = (ExprPMEM *) h;
-		patch_call1_expr(ctx, e->a);
-		break;
-	}
-	case EXPR_CALL: {
-		ExprCALL *e = (ExprCALL *) h;
-		if (ctx->managed_count == 0)
-			break;
-		if (e->func->type == EXPR_IDENT) {
-			ExprIDENT *i = (ExprIDENT *) e->func;
-			if (map_get(&ctx->managed_symbols, i->id)) {
-				i->id = addprefix(i->id);
-				exprCALL_prepend(
-					e,
-					exprIDENT("__myctx"));
-			} else if (strcmp(i->id, "__new_") == 0) {
-				e->func = exprIDENT("allocator_memalloc");
-				exprCALL_prepend(e,
-						 exprPMEM(exprIDENT("__myctx"),
-							 "allocator"));
-			}
-		}
-		Expr *e1;
-		int i;
-		avec_foreach(&e->args, e1, i) {
-			patch_call1_expr(ctx, e1);
-		}
-		break;
-	}
-	case EXPR_BOP: {
-		ExprBOP *e = (ExprBOP *) h;
-		patch_call1_expr(ctx, e->a);
-		patch_call1_expr(ctx, e->b);
-		break;
-	}
-	case EXPR_UOP: {
-		ExprUOP *e = (ExprUOP *) h;
-		patch_call1_expr(ctx, e->e);
-		break;
-	}
-	case EXPR_COND: {
-		ExprCOND *e = (ExprCOND *) h;
-		patch_call1_expr(ctx, e->c);
-		if (e->a)
-			patch_call1_expr(ctx, e->a);
-		patch_call1_expr(ctx, e->b);
-		break;
-	}
-	case EXPR_CAST: {
-		ExprCAST *e = (ExprCAST *) h;
-		patch_call1_expr(ctx, e->e);
-		break;
-	}
-	case EXPR_SIZEOF: {
-		ExprSIZEOF *e = (ExprSIZEOF *) h;
-		patch_call1_expr(ctx, e->e);
-		break;
-	}
-	case EXPR_SIZEOFT: {
-		ExprSIZEOFT *e = (ExprSIZEOFT *) h;
-		break;
-	}
-	case EXPR_INIT: {
-		ExprINIT *e = (ExprINIT *) h;
-		ExprINITItem item;
-		int i;
-		avec_foreach(&e->items, item, i) {
-			patch_call1_expr(ctx, item.value);
-		}
-		break;
-	}
-	case EXPR_GENERIC: {
-		ExprGENERIC *e = (ExprGENERIC *) h;
-		patch_call1_expr(ctx, e->expr);
-		GENERICPair *item;
-		int i;
-		avec_foreach_ptr(&e->items, item, i) {
-			patch_call1_expr(ctx, item->expr);
-		}
-		break;
-	}
-	default:
-		break;
-	}
+	if (is_managed_fundecl(h))
+		CALL_MANAGED(patch_fundecl, ((Patch *) v->data)->ctx,
+			     (StmtFUNDECL *) h);
+	return VISIT_SKIP;
 }
 
-static void patch_call1_stmt(Patch *ctx, Stmt *h)
+static int patch_decls_stmt(Visitor *v, Stmt *h)
 {
-	switch (h->type) {
-	case STMT_EXPR: {
-		StmtEXPR *s = (StmtEXPR *) h;
-		patch_call1_expr(ctx, s->expr);
-		break;
-	}
-	case STMT_IF: {
-		StmtIF *s = (StmtIF *) h;
-		patch_call1_expr(ctx, s->cond);
-		patch_call1_stmt(ctx, s->body1);
-		if (s->body2) {
-			patch_call1_stmt(ctx, s->body2);
-		}
-		break;
-	}
-	case STMT_WHILE: {
-		StmtWHILE *s = (StmtWHILE *) h;
-		patch_call1_expr(ctx, s->cond);
-		patch_call1_stmt(ctx, s->body);
-		break;
-	}
-	case STMT_DO: {
-		StmtDO *s = (StmtDO *) h;
-		patch_call1_stmt(ctx, s->body);
-		patch_call1_expr(ctx, s->cond);
-		break;
-	}
-	case STMT_FOR: {
-		StmtFOR *s = (StmtFOR *) h;
-		if (s->init) patch_call1_expr(ctx, s->init);
-		if (s->cond) patch_call1_expr(ctx, s->cond);
-		if (s->step) patch_call1_expr(ctx, s->step);
-		patch_call1_stmt(ctx, s->body);
-		break;
-	}
-	case STMT_FOR99: {
-		StmtFOR99 *s = (StmtFOR99 *) h;
-		patch_call1_stmt(ctx, (Stmt *) s->init);
-		if (s->cond) patch_call1_expr(ctx, s->cond);
-		if (s->step) patch_call1_expr(ctx, s->step);
-		patch_call1_stmt(ctx, s->body);
-		break;
-	}
-	case STMT_BREAK: {
-		break;
-	}
-	case STMT_CONTINUE: {
-		break;
-	}
-	case STMT_SWITCH: {
-		StmtSWITCH *s = (StmtSWITCH *) h;
-		patch_call1_expr(ctx, s->expr);
-		patch_call1_stmt(ctx, s->body);
-		break;
-	}
-	case STMT_CASE: {
-		StmtCASE *s = (StmtCASE *) h;
-		patch_call1_expr(ctx, s->expr);
-		patch_call1_stmt(ctx, s->stmt);
-		break;
-	}
-	case STMT_DEFAULT: {
-		StmtDEFAULT *s = (StmtDEFAULT *) h;
-		patch_call1_stmt(ctx, s->stmt);
-		break;
-	}
-	case STMT_LABEL: {
-		StmtLABEL *s = (StmtLABEL *) h;
-		patch_call1_stmt(ctx, s->stmt);
-		break;
-	}
-	case STMT_GOTO: {
-		StmtGOTO *s = (StmtGOTO *) h;
-		break;
-	}
-	case STMT_RETURN: {
-		StmtRETURN *s = (StmtRETURN *) h;
-		if (s->expr) {
-			patch_call1_expr(ctx, s->expr);
-		}
-		break;
-	}
-	case STMT_SKIP: {
-		break;
-	}
-	case STMT_BLOCK: {
-		StmtBLOCK *s = (StmtBLOCK *) h;
-		Stmt *s1;
-		int i;
-		avec_foreach(&s->items, s1, i) {
-			patch_call1_stmt(ctx, s1);
-		}
-		break;
-	}
-	case STMT_FUNDECL: {
-		StmtFUNDECL *s = (StmtFUNDECL *) h;
-		break;
-	}
-	case STMT_VARDECL: {
-		StmtVARDECL *s = (StmtVARDECL *) h;
-		if (s->init) {
-			patch_call1_expr(ctx, s->init);
-		}
-		break;
-	}
-	case STMT_LABELDECL: {
-		break;
-	}
-	case STMT_TYPEDEF: {
-		StmtTYPEDEF *s = (StmtTYPEDEF *) h;
-		break;
-	}
-	case STMT_DECLS: {
-		StmtDECLS *s = (StmtDECLS *) h;
-		Stmt *s1;
-		int i;
-		avec_foreach(&s->items, s1, i) {
-			patch_call1_stmt(ctx, s1);
-		}
-		break;
-	}
-	case STMT_GOTOADDR: {
-		StmtGOTOADDR *s = (StmtGOTOADDR *) h;
-		patch_call1_expr(ctx, s->expr);
-		break;
-	}
-	case STMT_CASERANGE: {
-		StmtCASERANGE *s = (StmtCASERANGE *) h;
-		patch_call1_expr(ctx, s->low);
-		patch_call1_expr(ctx, s->high);
-		patch_call1_stmt(ctx, s->stmt);
-		break;
-	}
-	case STMT_ASM: {
-		break;
-	}
-	case STMT_STATICASSERT: {
-		break;
-	}
-	case STMT_PRAGMA: {
-		break;
-	}
-	default:
-		abort();
-	}
+	return h->type == STMT_DECLS ? VISIT_CONTINUE : VISIT_SKIP;
 }
 
-static void patch_call_stmt(Patch *ctx, StmtBLOCK *s)
+// passes the context on in calls from managed functions
+static int patch_calls_fundecl(Visitor *v, Stmt *h)
 {
-	Stmt *s1;
-	int i;
-	avec_foreach(&s->items, s1, i) {
-		patch_call1_stmt(ctx, s1);
-	}
+	Patch *ctx = v->data;
+	StmtFUNDECL *s = (StmtFUNDECL *) h;
+	if (s->flags & DFLAG_MANAGED) {
+		ctx->managed_count++;
+		// the calls are in the statements
+		if (s->body &&
+		    !CALL_MANAGED(parse_fundecl_body, ctx->ctx, ctx->parser, s))
+			ctx->failed = true;
+	}
+	// nothing to rewrite outside managed functions
+	return ctx->managed_count ? VISIT_CONTINUE : VISIT_SKIP;
 }
 
-static void patch_call(Patch *ctx, Stmt *h)
+static void patch_calls_fundecl_post(Visitor *v, Stmt *h)
 {
-	switch (h->type) {
-	case STMT_FUNDECL: {
-		StmtFUNDECL *s = (StmtFUNDECL *) h;
-		if (s->flags & DFLAG_MANAGED)
-			ctx->managed_count++;
-		if (s->body)
-			patch_call_stmt(ctx, s->body);
-		if (s->flags & DFLAG_MANAGED)
-			ctx->managed_count--;
-		break;
-	}
-	case STMT_DECLS: {
-		StmtDECLS *s = (StmtDECLS *) h;
-		int i;
-		Stmt *s1;
-		avec_foreach(&s->items, s1, i) {
-			patch_call(ctx, s1);
-		}
-		break;
-	}
-	default:
-		break;
-	}
+	Patch *ctx = v->data;
+	if (((StmtFUNDECL *) h)->flags & DFLAG_MANAGED)
+		ctx->managed_count--;
+}
+
+static int patch_calls_stmt(Visitor *v, Stmt *h)
+{
+	Patch *ctx = v->data;
+	return ctx->managed_count || h->type == STMT_DECLS ?
+		VISIT_CONTINUE : VISIT_SKIP;
+}
+
+static int patch_calls_call(Visitor *v, Expr *h)
+{
+	Patch *ctx = v->data;
+	CALL_MANAGED(patch_callexpr, ctx->ctx, ctx, (ExprCALL *) h);
+	return VISIT_CONTINUE;
+}
+
+static int patch_calls_type(Visitor *v, Type *h)
+{
+	return VISIT_SKIP;
+}
+
+static void patch_init(Patch *ctx, Context *c, Parser *p)
+{
+	map_init(&ctx->managed_symbols);
+	ctx->managed_count = 0;
+	ctx->failed = false;
+	ctx->ctx = c;
+	ctx->parser = p;
+	ctx->decls = (Visitor) {
+		.pre[STMT_FUNDECL] = patch_decls_fundecl,
+		.stmt = patch_decls_stmt,
+		.data = ctx,
+	};
+	ctx->calls = (Visitor) {
+		.pre[STMT_FUNDECL] = patch_calls_fundecl,
+		.post[STMT_FUNDECL] = patch_calls_fundecl_post,
+		.pre[EXPR_CALL] = patch_calls_call,
+		.stmt = patch_calls_stmt,
+		.type = patch_calls_type,
+		.data = ctx,
+	};
+	// both rewrites share one walk over each declaration
+	passes_init(&ctx->passes);
+	passes_add(&ctx->passes, &ctx->decls);
+	passes_add(&ctx->passes, &ctx->calls);
+}
+
+static void patch_deinit(Patch *ctx)
+{
+	passes_deinit(&ctx->passes);
+	map_deinit(&ctx->managed_symbols);
+}
+
+// declare-before-use is enough for a single pass over the declarations
+static void patch_item(Patch *ctx, Stmt *s)
+{
+	patch_scan(ctx, s);
+	passes_run(&ctx->passes, s);
 }
 
-static void patch(StmtBLOCK *s)
+// false if a managed function could not be rewritten
+static bool patch(Context *c, Parser *p, StmtBLOCK *s)
 {
 	Patch pctx;
-	map_init(&pctx.managed_symbols);
+	patch_init(&pctx, c, p);
 
 	Stmt *s1;
 	int i;
 	avec_foreach(&s->items, s1, i) {
-		patch_decl(&pctx, s1);
+		patch_scan(&pctx, s1);
 	}
-
-	pctx.managed_count = 0;
 	avec_foreach(&s->items, s1, i) {
-		patch_call(&pctx, s1);
+		passes_run(&pctx.passes, s1);
 	}
-	map_deinit(&pctx.managed_symbols);
+	patch_deinit(&pctx);
+	return !pctx.failed;
 }
-END_MANAGED
 
 BEGIN_MANAGED
 StmtBLOCK *elim_unused(StmtBLOCK *tu);
 END_MANAGED
 
-static int main1(const char *file)
+#define ARENA_REGION (1L << 30)
+
+static bool compact;
+static int jobs = 1;
+static bool stream;
+static bool skim = true;
+static bool lazy = true;
+static long max_tokens;	// 0 for no limit
+static long max_memory;	// bytes, 0 for no limit
+static bool with_stats;
+static const char *stats_json;
+static const char *trace_path;
+// declarations taking this many input bytes get their own span
+static long trace_decls;
+
+static Printer *printer_for_output(LocTable *locs)
+{
+	Printer *pt = printer_new();
+	printer_set_minimal_parens(pt, true);
+	printer_set_compact(pt, compact);
+	printer_set_locations(pt, locs);
+	return pt;
+}
+
+static Parser *parser_for_input(Lexer *l, Allocator *a, LocTable *locs)
+{
+	Parser *p = parser_new(l, a);
+	parser_set_locations(p, locs);
+	parser_set_recovery(p, true);
+	parser_set_skim(p, skim);
+	parser_set_lazy(p, lazy);
+	parser_set_token_limit(p, max_tokens);
+	allocator_set_limit(a, max_memory);
+	return p;
+}
+
+static void report_budget(const char *file, Allocator *a, Allocator *ta)
+{
+	long peak = allocator_peak(a) + (ta ? allocator_peak(ta) : 0);
+	fprintf(stderr, "cast: %s: over budget (%ld KB peak), passed through\n",
+		file, peak >> 10);
+}
+
+// the input from off on, printed as it was read
+static Stmt *pass_through(Context *ctx, Lexer *l, long off)
+{
+	long len;
+	const char *text = lexer_input(l, &len);
+	return CALL_MANAGED(stmtOPAQUE, ctx, text + off, len - off);
+}
+
+static Stats *stats_for_input(Stats *s)
+{
+	if (!with_stats && !trace_path)
+		return NULL;
+	stats_begin(s, trace_path);
+	return s;
+}
+
+static void trace_decl(Stats *s, Stmt *h, double start, LexerMark m, Lexer *l)
+{
+	long bytes = lexer_mark(l).off - m.off;
+	if (trace_decls && bytes >= trace_decls)
+		stats_decl_span(s, h, start, m.line, bytes);
+}
+
+static void report_stats(Stats *s, Lexer *l, const char *file)
+{
+	if (!s)
+		return;
+	s->file = *lexer_report_file(l) ? lexer_report_file(l) : file;
+	s->tokens = lexer_token_count(l);
+	if (with_stats)
+		stats_print(s, stats_json);
+	if (trace_path)
+		stats_write_trace(s, trace_path);
+	stats_end(s);
+}
+
+// parse_translation_unit(), taking the time of each declaration
+BEGIN_MANAGED
+static StmtBLOCK *parse_traced(Parser *p, Lexer *l, Stats *stats)
+{
+	StmtBLOCK *tu = stmtBLOCK();
+	parser_begin_unit(p);
+	while (!parser_end_of_unit(p)) {
+		LexerMark m = lexer_mark(l);
+		double start = stats_now();
+		Stmt *s = parse_external_decl(p);
+		if (!s) {
+			tu = NULL;
+			break;
+		}
+		trace_decl(stats, s, start, m, l);
+		stmtBLOCK_append(tu, s);
+	}
+	parser_end_unit(p);
+	return tu;
+}
+END_MANAGED
+
+/* the items in error are printed as they were read, but for the last
+   unprinted ones */
+static void report_errors(Parser *p, int unprinted)
+{
+	int n;
+	const ParseError *e = parser_errors(p, &n);
+	for (int i = 0; i < n; i++)
+		fprintf(stderr, "%s:%d: syntax error%s\n", e[i].path,
+			e[i].line, i < n - unprinted ? ", passed through" : "");
+}
+
+/* parse, patch and print one external declaration at a time; trees
+   live in their own arena, which is reset after each declaration.
+   Whole-unit passes (elim_unused) are skipped, so the output is valid
+   but may keep unused declarations. */
+static int main1_stream(Allocator *a, const char *file)
 {
 	int ret = 0;
 	TextStream *ts = text_stream_new(file);
-	Lexer *l = lexer_new(ts);
-	Parser *p = parser_new(l);
+	Lexer *l = lexer_new(ts, a);
+	LocTable *locs = loctable_new(a);
+	Parser *p = parser_for_input(l, a, locs);
+
+	Allocator *ta = allocator_new();
+	allocator_set_limit(ta, max_memory);
+	parser_watch_allocator(p, ta);
+	Context *ctx = context_new(ta);
+	Printer *pt = printer_for_output(locs);
+	Patch pctx;
+	patch_init(&pctx, ctx, p);
+
+	Stats st, *stats = stats_for_input(&st);
+	if (stats)
+		stats->phase_spans = false;
+	char path[256];
+	path[255] = 0;
+	parser_begin_unit(p);
+	while (!parser_end_of_unit(p)) {
+		LexerMark m = lexer_mark(l);
+		strncpy(path, lexer_report_path(l), 255);
+		double start = stats ? stats_now() : 0;
+		phase_begin(stats, PHASE_PARSE);
+		Stmt *s = CALL_MANAGED(parse_external_decl, ctx, p);
+		phase_end(stats, PHASE_PARSE);
+		if (s && !parser_over_budget(p)) {
+			phase_begin(stats, PHASE_PATCH);
+			patch_item(&pctx, s);
+			phase_end(stats, PHASE_PATCH);
+		}
+		// lazy bodies are parsed by patch
+		if (parser_over_budget(p)) {
+			loctable_clear(locs);
+			allocator_reset(ta);
+			s = pass_through(ctx, l, m.off);
+			loctable_set(locs, s, loctable_file(locs, path), m.line);
+			printer_print_decl(pt, s);
+			break;
+		}
+		if (!s) {
+			fprintf(stderr, "%s:%d: syntax error\n",
+				lexer_report_path(l),
+				lexer_report_line(l));
+			ret = 1;
+			break;
+		}
+		if (pctx.failed) {
+			ret = 1;
+			break;
+		}
+		stats_count_item(stats, s);
+		phase_begin(stats, PHASE_PRINT);
+		printer_print_decl(pt, s);
+		phase_end(stats, PHASE_PRINT);
+		if (stats)
+			trace_decl(stats, s, start, m, l);
+		loctable_clear(locs);
+		allocator_reset(ta);
+	}
+	parser_end_unit(p);
+	// a managed body that didn't parse is the last error
+	report_errors(p, pctx.failed);
+	if (parser_over_budget(p))
+		report_budget(file, a, ta);
+	else if (!ret)
+		fprintf(stderr, "cast: preprocessing %s\n", lexer_report_file(l));
+	if (stats) {
+		stats->kept = stats->decls;
+		// the tree arena at its largest item
+		stats->arena = allocator_peak(a) + allocator_peak(ta);
+		stats->output = printer_output_bytes(pt);
+		report_stats(stats, l, file);
+	}
+
+	printer_delete(pt);
+	patch_deinit(&pctx);
+	parser_delete(p);
+	context_delete(ctx);
+	allocator_delete(ta);
+	loctable_delete(locs);
+	lexer_delete(l);
+	text_stream_delete(ts);
+	return ret;
+}
+
+static int main1(Allocator *a, const char *file)
+{
+	// parallel printing needs the whole unit
+	if (stream && jobs <= 1)
+		return main1_stream(a, file);
+	int ret = 0;
+	TextStream *ts = text_stream_new(file);
+	Lexer *l = lexer_new(ts, a);
+	LocTable *locs = loctable_new(a);
+	Parser *p = parser_for_input(l, a, locs);
 
-	Allocator *a = allocator_new();
 	Context *ctx = context_new(a);
-	StmtBLOCK *translation_unit = CALL_MANAGED(parse_translation_unit, ctx, p);
-	if (translation_unit) {
+	Stats st, *stats = stats_for_input(&st);
+	phase_begin(stats, PHASE_PARSE);
+	StmtBLOCK *translation_unit = stats && trace_decls ?
+		CALL_MANAGED(parse_traced, ctx, p, l, stats) :
+		CALL_MANAGED(parse_translation_unit, ctx, p);
+	phase_end(stats, PHASE_PARSE);
+	bool patched = true;
+	if (translation_unit && !parser_over_budget(p)) {
+		phase_begin(stats, PHASE_PATCH);
+		patched = patch(ctx, p, translation_unit);
+		phase_end(stats, PHASE_PATCH);
+	}
+	// lazy bodies are parsed by patch
+	if (parser_over_budget(p)) {
+		report_budget(file, a, NULL);
+		translation_unit = CALL_MANAGED(stmtBLOCK, ctx);
+		CALL_MANAGED(stmtBLOCK_append, ctx, translation_unit,
+			     pass_through(ctx, l, 0));
+		Printer *pt = printer_for_output(locs);
+		printer_print_translation_unit(pt, translation_unit);
+		printer_delete(pt);
+	} else if (translation_unit && patched) {
 		fprintf(stderr, "cast: preprocessing %s\n", lexer_report_file(l));
-		CALL_MANAGED(patch, ctx, translation_unit);
+		if (stats) {
+			Stmt *s1;
+			int i;
+			avec_foreach(&translation_unit->items, s1, i)
+				stats_count_item(stats, s1);
+			stats->kept = stats->decls;
+		}
 #ifdef __CAST_MANAGED__
+		phase_begin(stats, PHASE_ELIM);
 		translation_unit = CALL_MANAGED(elim_unused, ctx, translation_unit);
+		phase_end(stats, PHASE_ELIM);
+		if (stats)
+			stats->kept = translation_unit->items.length;
 #endif
-		Printer *pt = printer_new();
-		printer_print_translation_unit(pt, translation_unit);
+		Printer *pt = printer_for_output(locs);
+		phase_begin(stats, PHASE_PRINT);
+		printer_print_translation_unit_parallel(pt, translation_unit, jobs);
+		phase_end(stats, PHASE_PRINT);
+		if (stats)
+			stats->output = printer_output_bytes(pt);
 		printer_delete(pt);
+	} else if (translation_unit) {
+		// its calls would be left without the context
+		ret = 1;
 	} else {
 		fprintf(stderr, "%s:%d: syntax error\n",
 			lexer_report_path(l),
 			lexer_report_line(l));
 		ret = 1;
 	}
+	// nothing is printed for a managed body in error
+	int n;
+	parser_errors(p, &n);
+	report_errors(p, patched ? 0 : n);
+	if (stats) {
+		stats->arena = allocator_peak(a);
+		report_stats(stats, l, file);
+	}
 
 	parser_delete(p);
+	loctable_delete(locs);
 	context_delete(ctx);
 	lexer_delete(l);
 	text_stream_delete(ts);
-	allocator_delete(a);
 	return ret;
 }
 
 int main(int argc, char *argv[])
 {
-	return main1(argc == 1 ? "-" : argv[1]);
+	int ret = 0;
+	int nfiles = 0;
+	Allocator *a = allocator_new_mapped(ARENA_REGION);
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--compact")) {
+			compact = true;
+			continue;
+		}
+		if (!strcmp(argv[i], "--stream")) {
+			stream = true;
+			continue;
+		}
+		if (!strcmp(argv[i], "--no-skim")) {
+			skim = false;
+			continue;
+		}
+		if (!strcmp(argv[i], "--no-lazy")) {
+			lazy = false;
+			continue;
+		}
+		if (!strncmp(argv[i], "--max-tokens=", 13)) {
+			max_tokens = atol(argv[i] + 13);
+			continue;
+		}
+		if (!strncmp(argv[i], "--max-memory=", 13)) {
+			max_memory = atol(argv[i] + 13) << 20;
+			continue;
+		}
+		if (!strcmp(argv[i], "--cast-stats")) {
+			with_stats = true;
+			continue;
+		}
+		if (!strncmp(argv[i], "--cast-stats=", 13)) {
+			with_stats = true;
+			stats_json = argv[i] + 13;
+			continue;
+		}
+		if (!strncmp(argv[i], "--cast-trace=", 13)) {
+			trace_path = argv[i] + 13;
+			continue;
+		}
+		if (!strncmp(argv[i], "--cast-trace-decls=", 19)) {
+			trace_decls = atol(argv[i] + 19);
+			continue;
+		}
+		if (!strncmp(argv[i], "--jobs=", 7)) {
+			jobs = atoi(argv[i] + 7);
+			continue;
+		}
+		if (nfiles++) {
+			allocator_reset(a);
+			allocator_reset_peak(a);
+		}
+		ret |= main1(a, argv[i]);
+	}
+	if (!nfiles)
+		ret = main1(a, "-");
+	allocator_delete(a);
+	return ret;
 }
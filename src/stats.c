@@ -0,0 +1,266 @@
+#include <cast/map.h>
+#include <cast/visit.h>
+
+#include "stats.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static const char *const kind_names[VISIT_KINDS] = {
+#define STMT(id, ...) [STMT_##id] = "STMT_" #id,
+#define EXPR(id, ...) [EXPR_##id] = "EXPR_" #id,
+#define TYPE(id, ...) [TYPE_##id] = "TYPE_" #id,
+#include <cast/tree_nodes.def>
+#undef STMT
+#undef EXPR
+#undef TYPE
+	[STMT_BLOCK] = "STMT_BLOCK",
+	[STMT_DECLS] = "STMT_DECLS",
+	[STMT_ASM] = "STMT_ASM",
+	[STMT_SKIM] = "STMT_SKIM",
+	[STMT_LAZY] = "STMT_LAZY",
+	[EXPR_CALL] = "EXPR_CALL",
+	[EXPR_INIT] = "EXPR_INIT",
+	[EXPR_INITPACK] = "EXPR_INITPACK",
+	[EXPR_GENERIC] = "EXPR_GENERIC",
+	[TYPE_FUN] = "TYPE_FUN",
+};
+
+static const char *const phase_names[PHASES] = {
+	"parse", "patch", "elim", "print",
+};
+
+double stats_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void stats_begin(Stats *s, bool trace)
+{
+	if (!s)
+		return;
+	memset(s, 0, sizeof(Stats));
+	s->map_probes = map_probe_count();
+	s->trace = s->phase_spans = trace;
+	s->begin = stats_now();
+	vec_init(&s->spans);
+}
+
+void phase_begin(Stats *s, int phase)
+{
+	if (!s)
+		return;
+	s->phase = phase;
+	s->start = stats_now();
+}
+
+void phase_end(Stats *s, int phase)
+{
+	if (!s)
+		return;
+	assert(phase == s->phase);
+	double dur = stats_now() - s->start;
+	s->time[phase] += dur;
+	if (s->phase_spans) {
+		TraceSpan t = { NULL, phase, 0, 0, s->start, dur };
+		vec_push(&s->spans, t);
+	}
+}
+
+static const char *decl_name(Stmt *h)
+{
+	switch (h->type) {
+	case STMT_FUNDECL:
+		return ((StmtFUNDECL *) h)->name;
+	case STMT_VARDECL:
+		return ((StmtVARDECL *) h)->name;
+	case STMT_TYPEDEF:
+		return ((StmtTYPEDEF *) h)->name;
+	case STMT_DECLS: {
+		StmtDECLS *s = (StmtDECLS *) h;
+		return s->items.length ? decl_name(s->items.data[0]) : NULL;
+	}
+	case STMT_SKIM: {
+		StmtSKIM *s = (StmtSKIM *) h;
+		return s->defs.length ? s->defs.data[0] : NULL;
+	}
+	default:
+		return NULL;
+	}
+}
+
+void stats_decl_span(Stats *s, Stmt *h, double start, int line, long bytes)
+{
+	if (!s || !s->trace)
+		return;
+	// the tree goes away before the trace is written
+	const char *name = decl_name(h);
+	TraceSpan t = {
+		strdup(name ? name : kind_names[h->type]), 0, line, bytes,
+		start, stats_now() - start,
+	};
+	vec_push(&s->spans, t);
+}
+
+static int count_node(Visitor *v, Tree *h)
+{
+	Stats *s = v->data;
+	s->nodes[h->type]++;
+	return VISIT_CONTINUE;
+}
+
+void stats_count_item(Stats *s, Stmt *h)
+{
+	if (!s)
+		return;
+	Visitor v = {
+		.stmt = count_node,
+		.expr = count_node,
+		.type = count_node,
+		.data = s,
+	};
+	visit(&v, h);
+	s->decls += h->type == STMT_DECLS ? ((StmtDECLS *) h)->items.length : 1;
+}
+
+static void json_string(FILE *f, const char *s)
+{
+	fputc('"', f);
+	for (; *s; s++) {
+		if (*s == '"' || *s == '\\')
+			fprintf(f, "\\%c", *s);
+		else if ((unsigned char) *s < 0x20)
+			fprintf(f, "\\u%04x", *s);
+		else
+			fputc(*s, f);
+	}
+	fputc('"', f);
+}
+
+// one write, so that the output of parallel runs doesn't mix
+static void append_text(const char *path, const char *text, size_t len,
+			bool start_array)
+{
+	int fd = open(path, O_WRONLY | O_APPEND | O_CREAT | O_EXCL, 0666);
+	if (fd >= 0 && start_array && write(fd, "[\n", 2) != 2) {
+		close(fd);
+		fd = -1;
+	} else if (fd < 0 && errno == EEXIST) {
+		fd = open(path, O_WRONLY | O_APPEND);
+	}
+	if (fd < 0 || write(fd, text, len) != (ssize_t) len)
+		fprintf(stderr, "cast: cannot append to %s\n", path);
+	if (fd >= 0)
+		close(fd);
+}
+
+static void append_json(Stats *s, const char *path)
+{
+	char *line;
+	size_t len;
+	FILE *f = open_memstream(&line, &len);
+	fprintf(f, "{\"file\":");
+	json_string(f, s->file);
+	for (int i = 0; i < PHASES; i++)
+		fprintf(f, ",\"%s_ms\":%.3f", phase_names[i], s->time[i] * 1e3);
+	fprintf(f, ",\"tokens\":%ld,\"arena_bytes\":%ld,\"map_probes\":%ld,"
+		"\"decls\":%d,\"eliminated\":%d,\"output_bytes\":%ld,"
+		"\"nodes\":{",
+		s->tokens, s->arena, s->map_probes,
+		s->decls, s->decls - s->kept, s->output);
+	const char *sep = "";
+	for (int i = 0; i < VISIT_KINDS; i++) {
+		if (s->nodes[i]) {
+			fprintf(f, "%s\"%s\":%ld", sep, kind_names[i], s->nodes[i]);
+			sep = ",";
+		}
+	}
+	fprintf(f, "}}\n");
+	fclose(f);
+	append_text(path, line, len, false);
+	free(line);
+}
+
+void stats_print(Stats *s, const char *json_path)
+{
+	if (!s)
+		return;
+	s->map_probes = map_probe_count() - s->map_probes;
+	long nodes = 0;
+	for (int i = 0; i < VISIT_KINDS; i++)
+		nodes += s->nodes[i];
+
+	fprintf(stderr, "cast: stats for %s\n", s->file);
+	for (int i = 0; i < PHASES; i++)
+		fprintf(stderr, "  %-18s %10.3f ms\n", phase_names[i],
+			s->time[i] * 1e3);
+	fprintf(stderr, "  %-18s %10ld\n", "tokens lexed", s->tokens);
+	fprintf(stderr, "  %-18s %10ld KB\n", "arena peak", s->arena >> 10);
+	fprintf(stderr, "  %-18s %10ld\n", "map probes", s->map_probes);
+	fprintf(stderr, "  %-18s %10d of %d\n", "decls eliminated",
+		s->decls - s->kept, s->decls);
+	fprintf(stderr, "  %-18s %10ld\n", "output bytes", s->output);
+	fprintf(stderr, "  %-18s %10ld\n", "nodes", nodes);
+	for (int i = 0; i < VISIT_KINDS; i++)
+		if (s->nodes[i])
+			fprintf(stderr, "    %-16s %10ld\n", kind_names[i],
+				s->nodes[i]);
+	if (json_path)
+		append_json(s, json_path);
+}
+
+void stats_write_trace(Stats *s, const char *path)
+{
+	if (!s)
+		return;
+	char *text;
+	size_t len;
+	FILE *f = open_memstream(&text, &len);
+	int pid = getpid();
+	fprintf(f, "{\"name\":");
+	json_string(f, s->file);
+	fprintf(f, ",\"cat\":\"unit\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+		"\"pid\":%d,\"tid\":%d,\"args\":{\"file\":",
+		s->begin * 1e6, (stats_now() - s->begin) * 1e6, pid, pid);
+	json_string(f, s->file);
+	for (int i = 0; i < PHASES; i++)
+		fprintf(f, ",\"%s_ms\":%.3f", phase_names[i], s->time[i] * 1e3);
+	fprintf(f, "}},\n");
+	TraceSpan *t;
+	int i;
+	vec_foreach_ptr(&s->spans, t, i) {
+		fprintf(f, "{\"name\":");
+		json_string(f, t->name ? t->name : phase_names[t->phase]);
+		fprintf(f, ",\"cat\":\"%s\",\"ph\":\"X\","
+			"\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d,"
+			"\"args\":{\"file\":",
+			t->name ? "decl" : "phase", t->start * 1e6, t->dur * 1e6,
+			pid, pid);
+		json_string(f, s->file);
+		if (t->name)
+			fprintf(f, ",\"line\":%d,\"bytes\":%ld", t->line, t->bytes);
+		fprintf(f, "}},\n");
+	}
+	fclose(f);
+	append_text(path, text, len, true);
+	free(text);
+}
+
+void stats_end(Stats *s)
+{
+	if (!s)
+		return;
+	TraceSpan *t;
+	int i;
+	vec_foreach_ptr(&s->spans, t, i)
+		free(t->name);
+	vec_deinit(&s->spans);
+}
@@ -0,0 +1,64 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <cast/visit.h>
+#include <cast/vec.h>
+
+// what a unit spends its time on; lexing goes along with parsing
+enum {
+	PHASE_PARSE,
+	PHASE_PATCH,
+	PHASE_ELIM,
+	PHASE_PRINT,
+	PHASES,
+};
+
+// a phase, or the parsing of a top-level declaration
+typedef struct {
+	char *name;		// owned; NULL for a phase
+	int phase, line;
+	long bytes;
+	double start, dur;	// seconds
+} TraceSpan;
+
+/* the figures of one input file for --cast-stats, and its spans for
+   --cast-trace.  The functions take NULL for a run without either,
+   and do nothing then. */
+typedef struct {
+	const char *file;
+	double time[PHASES];	// seconds
+	int phase;		// running
+	double start;		// of it
+	long tokens;		// lexed, again after going back
+	long nodes[VISIT_KINDS];	// in the trees, by kind
+	long arena;		// bytes, at the most
+	long map_probes;
+	int decls, kept;	// top-level declarations before and after elim
+	long output;		// bytes
+	bool trace;
+	// the phases of each streamed item would be too many spans
+	bool phase_spans;
+	double begin;
+	vec_t(TraceSpan) spans;
+} Stats;
+
+void stats_begin(Stats *s, bool trace);
+void phase_begin(Stats *s, int phase);
+void phase_end(Stats *s, int phase);
+// adds the nodes and declarations of a top-level item
+void stats_count_item(Stats *s, Stmt *h);
+/* a span for parsing the item h, which started at start (a phase time)
+   and took bytes of input from line on */
+void stats_decl_span(Stats *s, Stmt *h, double start, int line, long bytes);
+double stats_now(void);
+/* prints the figures to stderr, and appends them as a JSON line to
+   json_path unless it is NULL */
+void stats_print(Stats *s, const char *json_path);
+/* appends the spans as Chrome trace events to path, inside one for
+   the whole file.  The file is started as a JSON array when created and
+   the array is never closed, which the trace viewers allow, so runs
+   can go on adding to it. */
+void stats_write_trace(Stats *s, const char *path);
+void stats_end(Stats *s);
+
+#endif /* STATS_H */
@@ -0,0 +1,28 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <cast/allocator.h>
+
+// allocations of odd sizes, across pages and after a reset
+static int misaligned(Allocator *a)
+{
+	int bad = 0;
+	for (int round = 0; round < 2; round++) {
+		for (int i = 0; i < 100000; i++)
+			bad += (uintptr_t) allocator_memalloc(a, 1 + i % 300) % 16 != 0;
+		bad += (uintptr_t) allocator_memalloc(a, 100000) % 16 != 0;
+		allocator_reset(a);
+	}
+	return bad;
+}
+
+int main(void)
+{
+	Allocator *a = allocator_new();
+	Allocator *m = allocator_new_mapped(1 << 20);
+	int bad = misaligned(a) + misaligned(m);
+	allocator_delete(a);
+	allocator_delete(m);
+	if (bad)
+		printf("%d allocations not aligned to 16 bytes\n", bad);
+	return bad != 0;
+}
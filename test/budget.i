@@ -0,0 +1,26 @@
+# 1 "budget.c"
+typedef struct { void *allocator; } Context;
+__managed {
+int g(int a);
+int f(int a)
+{
+	int s = 0;
+	s += g(a);
+	s += g(a);
+	s += g(a);
+	s += g(a);
+	s += g(a);
+	s += g(a);
+	s += g(a);
+	s += g(a);
+	s += g(a);
+	s += g(a);
+	s += g(a);
+	s += g(a);
+	return s;
+}
+int g(int a)
+{
+	return a + 1;
+}
+}
@@ -0,0 +1,456 @@
+# 1 "designators.c"
+typedef struct { void *allocator; } Context;
+struct point { int x, y; };
+struct box { struct point a, b; int tag[4]; };
+struct box b0 = { .a = { .x = 0, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f0(void) { struct point p = { .y = 0, .x = 1 }; return p.x + b0.a.y; }
+struct box b1 = { .a = { .x = 1, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f1(void) { struct point p = { .y = 1, .x = 1 }; return p.x + b1.a.y; }
+struct box b2 = { .a = { .x = 2, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f2(void) { struct point p = { .y = 2, .x = 1 }; return p.x + b2.a.y; }
+struct box b3 = { .a = { .x = 3, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f3(void) { struct point p = { .y = 3, .x = 1 }; return p.x + b3.a.y; }
+struct box b4 = { .a = { .x = 4, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f4(void) { struct point p = { .y = 4, .x = 1 }; return p.x + b4.a.y; }
+struct box b5 = { .a = { .x = 5, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f5(void) { struct point p = { .y = 5, .x = 1 }; return p.x + b5.a.y; }
+struct box b6 = { .a = { .x = 6, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f6(void) { struct point p = { .y = 6, .x = 1 }; return p.x + b6.a.y; }
+struct box b7 = { .a = { .x = 7, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f7(void) { struct point p = { .y = 7, .x = 1 }; return p.x + b7.a.y; }
+struct box b8 = { .a = { .x = 8, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f8(void) { struct point p = { .y = 8, .x = 1 }; return p.x + b8.a.y; }
+struct box b9 = { .a = { .x = 9, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f9(void) { struct point p = { .y = 9, .x = 1 }; return p.x + b9.a.y; }
+struct box b10 = { .a = { .x = 10, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f10(void) { struct point p = { .y = 10, .x = 1 }; return p.x + b10.a.y; }
+struct box b11 = { .a = { .x = 11, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f11(void) { struct point p = { .y = 11, .x = 1 }; return p.x + b11.a.y; }
+struct box b12 = { .a = { .x = 12, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f12(void) { struct point p = { .y = 12, .x = 1 }; return p.x + b12.a.y; }
+struct box b13 = { .a = { .x = 13, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f13(void) { struct point p = { .y = 13, .x = 1 }; return p.x + b13.a.y; }
+struct box b14 = { .a = { .x = 14, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f14(void) { struct point p = { .y = 14, .x = 1 }; return p.x + b14.a.y; }
+struct box b15 = { .a = { .x = 15, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f15(void) { struct point p = { .y = 15, .x = 1 }; return p.x + b15.a.y; }
+struct box b16 = { .a = { .x = 16, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f16(void) { struct point p = { .y = 16, .x = 1 }; return p.x + b16.a.y; }
+struct box b17 = { .a = { .x = 17, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f17(void) { struct point p = { .y = 17, .x = 1 }; return p.x + b17.a.y; }
+struct box b18 = { .a = { .x = 18, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f18(void) { struct point p = { .y = 18, .x = 1 }; return p.x + b18.a.y; }
+struct box b19 = { .a = { .x = 19, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f19(void) { struct point p = { .y = 19, .x = 1 }; return p.x + b19.a.y; }
+struct box b20 = { .a = { .x = 20, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f20(void) { struct point p = { .y = 20, .x = 1 }; return p.x + b20.a.y; }
+struct box b21 = { .a = { .x = 21, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f21(void) { struct point p = { .y = 21, .x = 1 }; return p.x + b21.a.y; }
+struct box b22 = { .a = { .x = 22, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f22(void) { struct point p = { .y = 22, .x = 1 }; return p.x + b22.a.y; }
+struct box b23 = { .a = { .x = 23, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f23(void) { struct point p = { .y = 23, .x = 1 }; return p.x + b23.a.y; }
+struct box b24 = { .a = { .x = 24, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f24(void) { struct point p = { .y = 24, .x = 1 }; return p.x + b24.a.y; }
+struct box b25 = { .a = { .x = 25, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f25(void) { struct point p = { .y = 25, .x = 1 }; return p.x + b25.a.y; }
+struct box b26 = { .a = { .x = 26, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f26(void) { struct point p = { .y = 26, .x = 1 }; return p.x + b26.a.y; }
+struct box b27 = { .a = { .x = 27, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f27(void) { struct point p = { .y = 27, .x = 1 }; return p.x + b27.a.y; }
+struct box b28 = { .a = { .x = 28, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f28(void) { struct point p = { .y = 28, .x = 1 }; return p.x + b28.a.y; }
+struct box b29 = { .a = { .x = 29, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f29(void) { struct point p = { .y = 29, .x = 1 }; return p.x + b29.a.y; }
+struct box b30 = { .a = { .x = 30, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f30(void) { struct point p = { .y = 30, .x = 1 }; return p.x + b30.a.y; }
+struct box b31 = { .a = { .x = 31, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f31(void) { struct point p = { .y = 31, .x = 1 }; return p.x + b31.a.y; }
+struct box b32 = { .a = { .x = 32, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f32(void) { struct point p = { .y = 32, .x = 1 }; return p.x + b32.a.y; }
+struct box b33 = { .a = { .x = 33, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f33(void) { struct point p = { .y = 33, .x = 1 }; return p.x + b33.a.y; }
+struct box b34 = { .a = { .x = 34, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f34(void) { struct point p = { .y = 34, .x = 1 }; return p.x + b34.a.y; }
+struct box b35 = { .a = { .x = 35, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f35(void) { struct point p = { .y = 35, .x = 1 }; return p.x + b35.a.y; }
+struct box b36 = { .a = { .x = 36, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f36(void) { struct point p = { .y = 36, .x = 1 }; return p.x + b36.a.y; }
+struct box b37 = { .a = { .x = 37, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f37(void) { struct point p = { .y = 37, .x = 1 }; return p.x + b37.a.y; }
+struct box b38 = { .a = { .x = 38, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f38(void) { struct point p = { .y = 38, .x = 1 }; return p.x + b38.a.y; }
+struct box b39 = { .a = { .x = 39, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f39(void) { struct point p = { .y = 39, .x = 1 }; return p.x + b39.a.y; }
+struct box b40 = { .a = { .x = 40, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f40(void) { struct point p = { .y = 40, .x = 1 }; return p.x + b40.a.y; }
+struct box b41 = { .a = { .x = 41, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f41(void) { struct point p = { .y = 41, .x = 1 }; return p.x + b41.a.y; }
+struct box b42 = { .a = { .x = 42, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f42(void) { struct point p = { .y = 42, .x = 1 }; return p.x + b42.a.y; }
+struct box b43 = { .a = { .x = 43, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f43(void) { struct point p = { .y = 43, .x = 1 }; return p.x + b43.a.y; }
+struct box b44 = { .a = { .x = 44, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f44(void) { struct point p = { .y = 44, .x = 1 }; return p.x + b44.a.y; }
+struct box b45 = { .a = { .x = 45, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f45(void) { struct point p = { .y = 45, .x = 1 }; return p.x + b45.a.y; }
+struct box b46 = { .a = { .x = 46, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f46(void) { struct point p = { .y = 46, .x = 1 }; return p.x + b46.a.y; }
+struct box b47 = { .a = { .x = 47, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f47(void) { struct point p = { .y = 47, .x = 1 }; return p.x + b47.a.y; }
+struct box b48 = { .a = { .x = 48, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f48(void) { struct point p = { .y = 48, .x = 1 }; return p.x + b48.a.y; }
+struct box b49 = { .a = { .x = 49, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f49(void) { struct point p = { .y = 49, .x = 1 }; return p.x + b49.a.y; }
+struct box b50 = { .a = { .x = 50, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f50(void) { struct point p = { .y = 50, .x = 1 }; return p.x + b50.a.y; }
+struct box b51 = { .a = { .x = 51, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f51(void) { struct point p = { .y = 51, .x = 1 }; return p.x + b51.a.y; }
+struct box b52 = { .a = { .x = 52, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f52(void) { struct point p = { .y = 52, .x = 1 }; return p.x + b52.a.y; }
+struct box b53 = { .a = { .x = 53, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f53(void) { struct point p = { .y = 53, .x = 1 }; return p.x + b53.a.y; }
+struct box b54 = { .a = { .x = 54, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f54(void) { struct point p = { .y = 54, .x = 1 }; return p.x + b54.a.y; }
+struct box b55 = { .a = { .x = 55, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f55(void) { struct point p = { .y = 55, .x = 1 }; return p.x + b55.a.y; }
+struct box b56 = { .a = { .x = 56, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f56(void) { struct point p = { .y = 56, .x = 1 }; return p.x + b56.a.y; }
+struct box b57 = { .a = { .x = 57, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f57(void) { struct point p = { .y = 57, .x = 1 }; return p.x + b57.a.y; }
+struct box b58 = { .a = { .x = 58, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f58(void) { struct point p = { .y = 58, .x = 1 }; return p.x + b58.a.y; }
+struct box b59 = { .a = { .x = 59, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f59(void) { struct point p = { .y = 59, .x = 1 }; return p.x + b59.a.y; }
+struct box b60 = { .a = { .x = 60, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f60(void) { struct point p = { .y = 60, .x = 1 }; return p.x + b60.a.y; }
+struct box b61 = { .a = { .x = 61, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f61(void) { struct point p = { .y = 61, .x = 1 }; return p.x + b61.a.y; }
+struct box b62 = { .a = { .x = 62, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f62(void) { struct point p = { .y = 62, .x = 1 }; return p.x + b62.a.y; }
+struct box b63 = { .a = { .x = 63, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f63(void) { struct point p = { .y = 63, .x = 1 }; return p.x + b63.a.y; }
+struct box b64 = { .a = { .x = 64, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f64(void) { struct point p = { .y = 64, .x = 1 }; return p.x + b64.a.y; }
+struct box b65 = { .a = { .x = 65, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f65(void) { struct point p = { .y = 65, .x = 1 }; return p.x + b65.a.y; }
+struct box b66 = { .a = { .x = 66, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f66(void) { struct point p = { .y = 66, .x = 1 }; return p.x + b66.a.y; }
+struct box b67 = { .a = { .x = 67, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f67(void) { struct point p = { .y = 67, .x = 1 }; return p.x + b67.a.y; }
+struct box b68 = { .a = { .x = 68, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f68(void) { struct point p = { .y = 68, .x = 1 }; return p.x + b68.a.y; }
+struct box b69 = { .a = { .x = 69, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f69(void) { struct point p = { .y = 69, .x = 1 }; return p.x + b69.a.y; }
+struct box b70 = { .a = { .x = 70, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f70(void) { struct point p = { .y = 70, .x = 1 }; return p.x + b70.a.y; }
+struct box b71 = { .a = { .x = 71, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f71(void) { struct point p = { .y = 71, .x = 1 }; return p.x + b71.a.y; }
+struct box b72 = { .a = { .x = 72, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f72(void) { struct point p = { .y = 72, .x = 1 }; return p.x + b72.a.y; }
+struct box b73 = { .a = { .x = 73, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f73(void) { struct point p = { .y = 73, .x = 1 }; return p.x + b73.a.y; }
+struct box b74 = { .a = { .x = 74, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f74(void) { struct point p = { .y = 74, .x = 1 }; return p.x + b74.a.y; }
+struct box b75 = { .a = { .x = 75, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f75(void) { struct point p = { .y = 75, .x = 1 }; return p.x + b75.a.y; }
+struct box b76 = { .a = { .x = 76, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f76(void) { struct point p = { .y = 76, .x = 1 }; return p.x + b76.a.y; }
+struct box b77 = { .a = { .x = 77, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f77(void) { struct point p = { .y = 77, .x = 1 }; return p.x + b77.a.y; }
+struct box b78 = { .a = { .x = 78, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f78(void) { struct point p = { .y = 78, .x = 1 }; return p.x + b78.a.y; }
+struct box b79 = { .a = { .x = 79, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f79(void) { struct point p = { .y = 79, .x = 1 }; return p.x + b79.a.y; }
+struct box b80 = { .a = { .x = 80, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f80(void) { struct point p = { .y = 80, .x = 1 }; return p.x + b80.a.y; }
+struct box b81 = { .a = { .x = 81, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f81(void) { struct point p = { .y = 81, .x = 1 }; return p.x + b81.a.y; }
+struct box b82 = { .a = { .x = 82, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f82(void) { struct point p = { .y = 82, .x = 1 }; return p.x + b82.a.y; }
+struct box b83 = { .a = { .x = 83, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f83(void) { struct point p = { .y = 83, .x = 1 }; return p.x + b83.a.y; }
+struct box b84 = { .a = { .x = 84, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f84(void) { struct point p = { .y = 84, .x = 1 }; return p.x + b84.a.y; }
+struct box b85 = { .a = { .x = 85, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f85(void) { struct point p = { .y = 85, .x = 1 }; return p.x + b85.a.y; }
+struct box b86 = { .a = { .x = 86, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f86(void) { struct point p = { .y = 86, .x = 1 }; return p.x + b86.a.y; }
+struct box b87 = { .a = { .x = 87, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f87(void) { struct point p = { .y = 87, .x = 1 }; return p.x + b87.a.y; }
+struct box b88 = { .a = { .x = 88, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f88(void) { struct point p = { .y = 88, .x = 1 }; return p.x + b88.a.y; }
+struct box b89 = { .a = { .x = 89, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f89(void) { struct point p = { .y = 89, .x = 1 }; return p.x + b89.a.y; }
+struct box b90 = { .a = { .x = 90, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f90(void) { struct point p = { .y = 90, .x = 1 }; return p.x + b90.a.y; }
+struct box b91 = { .a = { .x = 91, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f91(void) { struct point p = { .y = 91, .x = 1 }; return p.x + b91.a.y; }
+struct box b92 = { .a = { .x = 92, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f92(void) { struct point p = { .y = 92, .x = 1 }; return p.x + b92.a.y; }
+struct box b93 = { .a = { .x = 93, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f93(void) { struct point p = { .y = 93, .x = 1 }; return p.x + b93.a.y; }
+struct box b94 = { .a = { .x = 94, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f94(void) { struct point p = { .y = 94, .x = 1 }; return p.x + b94.a.y; }
+struct box b95 = { .a = { .x = 95, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f95(void) { struct point p = { .y = 95, .x = 1 }; return p.x + b95.a.y; }
+struct box b96 = { .a = { .x = 96, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f96(void) { struct point p = { .y = 96, .x = 1 }; return p.x + b96.a.y; }
+struct box b97 = { .a = { .x = 97, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f97(void) { struct point p = { .y = 97, .x = 1 }; return p.x + b97.a.y; }
+struct box b98 = { .a = { .x = 98, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f98(void) { struct point p = { .y = 98, .x = 1 }; return p.x + b98.a.y; }
+struct box b99 = { .a = { .x = 99, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f99(void) { struct point p = { .y = 99, .x = 1 }; return p.x + b99.a.y; }
+struct box b100 = { .a = { .x = 100, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f100(void) { struct point p = { .y = 100, .x = 1 }; return p.x + b100.a.y; }
+struct box b101 = { .a = { .x = 101, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f101(void) { struct point p = { .y = 101, .x = 1 }; return p.x + b101.a.y; }
+struct box b102 = { .a = { .x = 102, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f102(void) { struct point p = { .y = 102, .x = 1 }; return p.x + b102.a.y; }
+struct box b103 = { .a = { .x = 103, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f103(void) { struct point p = { .y = 103, .x = 1 }; return p.x + b103.a.y; }
+struct box b104 = { .a = { .x = 104, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f104(void) { struct point p = { .y = 104, .x = 1 }; return p.x + b104.a.y; }
+struct box b105 = { .a = { .x = 105, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f105(void) { struct point p = { .y = 105, .x = 1 }; return p.x + b105.a.y; }
+struct box b106 = { .a = { .x = 106, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f106(void) { struct point p = { .y = 106, .x = 1 }; return p.x + b106.a.y; }
+struct box b107 = { .a = { .x = 107, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f107(void) { struct point p = { .y = 107, .x = 1 }; return p.x + b107.a.y; }
+struct box b108 = { .a = { .x = 108, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f108(void) { struct point p = { .y = 108, .x = 1 }; return p.x + b108.a.y; }
+struct box b109 = { .a = { .x = 109, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f109(void) { struct point p = { .y = 109, .x = 1 }; return p.x + b109.a.y; }
+struct box b110 = { .a = { .x = 110, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f110(void) { struct point p = { .y = 110, .x = 1 }; return p.x + b110.a.y; }
+struct box b111 = { .a = { .x = 111, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f111(void) { struct point p = { .y = 111, .x = 1 }; return p.x + b111.a.y; }
+struct box b112 = { .a = { .x = 112, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f112(void) { struct point p = { .y = 112, .x = 1 }; return p.x + b112.a.y; }
+struct box b113 = { .a = { .x = 113, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f113(void) { struct point p = { .y = 113, .x = 1 }; return p.x + b113.a.y; }
+struct box b114 = { .a = { .x = 114, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f114(void) { struct point p = { .y = 114, .x = 1 }; return p.x + b114.a.y; }
+struct box b115 = { .a = { .x = 115, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f115(void) { struct point p = { .y = 115, .x = 1 }; return p.x + b115.a.y; }
+struct box b116 = { .a = { .x = 116, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f116(void) { struct point p = { .y = 116, .x = 1 }; return p.x + b116.a.y; }
+struct box b117 = { .a = { .x = 117, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f117(void) { struct point p = { .y = 117, .x = 1 }; return p.x + b117.a.y; }
+struct box b118 = { .a = { .x = 118, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f118(void) { struct point p = { .y = 118, .x = 1 }; return p.x + b118.a.y; }
+struct box b119 = { .a = { .x = 119, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f119(void) { struct point p = { .y = 119, .x = 1 }; return p.x + b119.a.y; }
+struct box b120 = { .a = { .x = 120, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f120(void) { struct point p = { .y = 120, .x = 1 }; return p.x + b120.a.y; }
+struct box b121 = { .a = { .x = 121, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f121(void) { struct point p = { .y = 121, .x = 1 }; return p.x + b121.a.y; }
+struct box b122 = { .a = { .x = 122, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f122(void) { struct point p = { .y = 122, .x = 1 }; return p.x + b122.a.y; }
+struct box b123 = { .a = { .x = 123, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f123(void) { struct point p = { .y = 123, .x = 1 }; return p.x + b123.a.y; }
+struct box b124 = { .a = { .x = 124, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f124(void) { struct point p = { .y = 124, .x = 1 }; return p.x + b124.a.y; }
+struct box b125 = { .a = { .x = 125, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f125(void) { struct point p = { .y = 125, .x = 1 }; return p.x + b125.a.y; }
+struct box b126 = { .a = { .x = 126, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f126(void) { struct point p = { .y = 126, .x = 1 }; return p.x + b126.a.y; }
+struct box b127 = { .a = { .x = 127, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f127(void) { struct point p = { .y = 127, .x = 1 }; return p.x + b127.a.y; }
+struct box b128 = { .a = { .x = 128, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f128(void) { struct point p = { .y = 128, .x = 1 }; return p.x + b128.a.y; }
+struct box b129 = { .a = { .x = 129, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f129(void) { struct point p = { .y = 129, .x = 1 }; return p.x + b129.a.y; }
+struct box b130 = { .a = { .x = 130, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f130(void) { struct point p = { .y = 130, .x = 1 }; return p.x + b130.a.y; }
+struct box b131 = { .a = { .x = 131, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f131(void) { struct point p = { .y = 131, .x = 1 }; return p.x + b131.a.y; }
+struct box b132 = { .a = { .x = 132, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f132(void) { struct point p = { .y = 132, .x = 1 }; return p.x + b132.a.y; }
+struct box b133 = { .a = { .x = 133, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f133(void) { struct point p = { .y = 133, .x = 1 }; return p.x + b133.a.y; }
+struct box b134 = { .a = { .x = 134, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f134(void) { struct point p = { .y = 134, .x = 1 }; return p.x + b134.a.y; }
+struct box b135 = { .a = { .x = 135, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f135(void) { struct point p = { .y = 135, .x = 1 }; return p.x + b135.a.y; }
+struct box b136 = { .a = { .x = 136, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f136(void) { struct point p = { .y = 136, .x = 1 }; return p.x + b136.a.y; }
+struct box b137 = { .a = { .x = 137, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f137(void) { struct point p = { .y = 137, .x = 1 }; return p.x + b137.a.y; }
+struct box b138 = { .a = { .x = 138, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f138(void) { struct point p = { .y = 138, .x = 1 }; return p.x + b138.a.y; }
+struct box b139 = { .a = { .x = 139, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f139(void) { struct point p = { .y = 139, .x = 1 }; return p.x + b139.a.y; }
+struct box b140 = { .a = { .x = 140, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f140(void) { struct point p = { .y = 140, .x = 1 }; return p.x + b140.a.y; }
+struct box b141 = { .a = { .x = 141, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f141(void) { struct point p = { .y = 141, .x = 1 }; return p.x + b141.a.y; }
+struct box b142 = { .a = { .x = 142, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f142(void) { struct point p = { .y = 142, .x = 1 }; return p.x + b142.a.y; }
+struct box b143 = { .a = { .x = 143, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f143(void) { struct point p = { .y = 143, .x = 1 }; return p.x + b143.a.y; }
+struct box b144 = { .a = { .x = 144, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f144(void) { struct point p = { .y = 144, .x = 1 }; return p.x + b144.a.y; }
+struct box b145 = { .a = { .x = 145, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f145(void) { struct point p = { .y = 145, .x = 1 }; return p.x + b145.a.y; }
+struct box b146 = { .a = { .x = 146, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f146(void) { struct point p = { .y = 146, .x = 1 }; return p.x + b146.a.y; }
+struct box b147 = { .a = { .x = 147, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f147(void) { struct point p = { .y = 147, .x = 1 }; return p.x + b147.a.y; }
+struct box b148 = { .a = { .x = 148, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f148(void) { struct point p = { .y = 148, .x = 1 }; return p.x + b148.a.y; }
+struct box b149 = { .a = { .x = 149, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f149(void) { struct point p = { .y = 149, .x = 1 }; return p.x + b149.a.y; }
+struct box b150 = { .a = { .x = 150, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f150(void) { struct point p = { .y = 150, .x = 1 }; return p.x + b150.a.y; }
+struct box b151 = { .a = { .x = 151, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f151(void) { struct point p = { .y = 151, .x = 1 }; return p.x + b151.a.y; }
+struct box b152 = { .a = { .x = 152, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f152(void) { struct point p = { .y = 152, .x = 1 }; return p.x + b152.a.y; }
+struct box b153 = { .a = { .x = 153, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f153(void) { struct point p = { .y = 153, .x = 1 }; return p.x + b153.a.y; }
+struct box b154 = { .a = { .x = 154, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f154(void) { struct point p = { .y = 154, .x = 1 }; return p.x + b154.a.y; }
+struct box b155 = { .a = { .x = 155, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f155(void) { struct point p = { .y = 155, .x = 1 }; return p.x + b155.a.y; }
+struct box b156 = { .a = { .x = 156, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f156(void) { struct point p = { .y = 156, .x = 1 }; return p.x + b156.a.y; }
+struct box b157 = { .a = { .x = 157, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f157(void) { struct point p = { .y = 157, .x = 1 }; return p.x + b157.a.y; }
+struct box b158 = { .a = { .x = 158, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f158(void) { struct point p = { .y = 158, .x = 1 }; return p.x + b158.a.y; }
+struct box b159 = { .a = { .x = 159, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f159(void) { struct point p = { .y = 159, .x = 1 }; return p.x + b159.a.y; }
+struct box b160 = { .a = { .x = 160, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f160(void) { struct point p = { .y = 160, .x = 1 }; return p.x + b160.a.y; }
+struct box b161 = { .a = { .x = 161, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f161(void) { struct point p = { .y = 161, .x = 1 }; return p.x + b161.a.y; }
+struct box b162 = { .a = { .x = 162, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f162(void) { struct point p = { .y = 162, .x = 1 }; return p.x + b162.a.y; }
+struct box b163 = { .a = { .x = 163, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f163(void) { struct point p = { .y = 163, .x = 1 }; return p.x + b163.a.y; }
+struct box b164 = { .a = { .x = 164, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f164(void) { struct point p = { .y = 164, .x = 1 }; return p.x + b164.a.y; }
+struct box b165 = { .a = { .x = 165, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f165(void) { struct point p = { .y = 165, .x = 1 }; return p.x + b165.a.y; }
+struct box b166 = { .a = { .x = 166, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f166(void) { struct point p = { .y = 166, .x = 1 }; return p.x + b166.a.y; }
+struct box b167 = { .a = { .x = 167, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f167(void) { struct point p = { .y = 167, .x = 1 }; return p.x + b167.a.y; }
+struct box b168 = { .a = { .x = 168, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f168(void) { struct point p = { .y = 168, .x = 1 }; return p.x + b168.a.y; }
+struct box b169 = { .a = { .x = 169, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f169(void) { struct point p = { .y = 169, .x = 1 }; return p.x + b169.a.y; }
+struct box b170 = { .a = { .x = 170, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f170(void) { struct point p = { .y = 170, .x = 1 }; return p.x + b170.a.y; }
+struct box b171 = { .a = { .x = 171, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f171(void) { struct point p = { .y = 171, .x = 1 }; return p.x + b171.a.y; }
+struct box b172 = { .a = { .x = 172, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f172(void) { struct point p = { .y = 172, .x = 1 }; return p.x + b172.a.y; }
+struct box b173 = { .a = { .x = 173, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f173(void) { struct point p = { .y = 173, .x = 1 }; return p.x + b173.a.y; }
+struct box b174 = { .a = { .x = 174, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f174(void) { struct point p = { .y = 174, .x = 1 }; return p.x + b174.a.y; }
+struct box b175 = { .a = { .x = 175, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f175(void) { struct point p = { .y = 175, .x = 1 }; return p.x + b175.a.y; }
+struct box b176 = { .a = { .x = 176, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f176(void) { struct point p = { .y = 176, .x = 1 }; return p.x + b176.a.y; }
+struct box b177 = { .a = { .x = 177, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f177(void) { struct point p = { .y = 177, .x = 1 }; return p.x + b177.a.y; }
+struct box b178 = { .a = { .x = 178, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f178(void) { struct point p = { .y = 178, .x = 1 }; return p.x + b178.a.y; }
+struct box b179 = { .a = { .x = 179, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f179(void) { struct point p = { .y = 179, .x = 1 }; return p.x + b179.a.y; }
+struct box b180 = { .a = { .x = 180, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f180(void) { struct point p = { .y = 180, .x = 1 }; return p.x + b180.a.y; }
+struct box b181 = { .a = { .x = 181, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f181(void) { struct point p = { .y = 181, .x = 1 }; return p.x + b181.a.y; }
+struct box b182 = { .a = { .x = 182, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f182(void) { struct point p = { .y = 182, .x = 1 }; return p.x + b182.a.y; }
+struct box b183 = { .a = { .x = 183, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f183(void) { struct point p = { .y = 183, .x = 1 }; return p.x + b183.a.y; }
+struct box b184 = { .a = { .x = 184, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f184(void) { struct point p = { .y = 184, .x = 1 }; return p.x + b184.a.y; }
+struct box b185 = { .a = { .x = 185, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f185(void) { struct point p = { .y = 185, .x = 1 }; return p.x + b185.a.y; }
+struct box b186 = { .a = { .x = 186, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f186(void) { struct point p = { .y = 186, .x = 1 }; return p.x + b186.a.y; }
+struct box b187 = { .a = { .x = 187, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f187(void) { struct point p = { .y = 187, .x = 1 }; return p.x + b187.a.y; }
+struct box b188 = { .a = { .x = 188, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f188(void) { struct point p = { .y = 188, .x = 1 }; return p.x + b188.a.y; }
+struct box b189 = { .a = { .x = 189, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f189(void) { struct point p = { .y = 189, .x = 1 }; return p.x + b189.a.y; }
+struct box b190 = { .a = { .x = 190, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f190(void) { struct point p = { .y = 190, .x = 1 }; return p.x + b190.a.y; }
+struct box b191 = { .a = { .x = 191, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f191(void) { struct point p = { .y = 191, .x = 1 }; return p.x + b191.a.y; }
+struct box b192 = { .a = { .x = 192, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f192(void) { struct point p = { .y = 192, .x = 1 }; return p.x + b192.a.y; }
+struct box b193 = { .a = { .x = 193, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f193(void) { struct point p = { .y = 193, .x = 1 }; return p.x + b193.a.y; }
+struct box b194 = { .a = { .x = 194, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f194(void) { struct point p = { .y = 194, .x = 1 }; return p.x + b194.a.y; }
+struct box b195 = { .a = { .x = 195, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f195(void) { struct point p = { .y = 195, .x = 1 }; return p.x + b195.a.y; }
+struct box b196 = { .a = { .x = 196, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f196(void) { struct point p = { .y = 196, .x = 1 }; return p.x + b196.a.y; }
+struct box b197 = { .a = { .x = 197, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f197(void) { struct point p = { .y = 197, .x = 1 }; return p.x + b197.a.y; }
+struct box b198 = { .a = { .x = 198, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f198(void) { struct point p = { .y = 198, .x = 1 }; return p.x + b198.a.y; }
+struct box b199 = { .a = { .x = 199, .y = 2 }, .b.y = 3, .tag = { [1] = 4, [2 ... 3] = 5 } };
+int f199(void) { struct point p = { .y = 199, .x = 1 }; return p.x + b199.a.y; }
+__managed {
+int g0(void) { struct box q = { .b = { .x = 0 }, .tag[2] = 1 }; return f0() + q.b.x; }
+int g1(void) { struct box q = { .b = { .x = 1 }, .tag[2] = 1 }; return f1() + q.b.x; }
+int g2(void) { struct box q = { .b = { .x = 2 }, .tag[2] = 1 }; return f2() + q.b.x; }
+int g3(void) { struct box q = { .b = { .x = 3 }, .tag[2] = 1 }; return f3() + q.b.x; }
+int g4(void) { struct box q = { .b = { .x = 4 }, .tag[2] = 1 }; return f4() + q.b.x; }
+int g5(void) { struct box q = { .b = { .x = 5 }, .tag[2] = 1 }; return f5() + q.b.x; }
+int g6(void) { struct box q = { .b = { .x = 6 }, .tag[2] = 1 }; return f6() + q.b.x; }
+int g7(void) { struct box q = { .b = { .x = 7 }, .tag[2] = 1 }; return f7() + q.b.x; }
+int g8(void) { struct box q = { .b = { .x = 8 }, .tag[2] = 1 }; return f8() + q.b.x; }
+int g9(void) { struct box q = { .b = { .x = 9 }, .tag[2] = 1 }; return f9() + q.b.x; }
+int g10(void) { struct box q = { .b = { .x = 10 }, .tag[2] = 1 }; return f10() + q.b.x; }
+int g11(void) { struct box q = { .b = { .x = 11 }, .tag[2] = 1 }; return f11() + q.b.x; }
+int g12(void) { struct box q = { .b = { .x = 12 }, .tag[2] = 1 }; return f12() + q.b.x; }
+int g13(void) { struct box q = { .b = { .x = 13 }, .tag[2] = 1 }; return f13() + q.b.x; }
+int g14(void) { struct box q = { .b = { .x = 14 }, .tag[2] = 1 }; return f14() + q.b.x; }
+int g15(void) { struct box q = { .b = { .x = 15 }, .tag[2] = 1 }; return f15() + q.b.x; }
+int g16(void) { struct box q = { .b = { .x = 16 }, .tag[2] = 1 }; return f16() + q.b.x; }
+int g17(void) { struct box q = { .b = { .x = 17 }, .tag[2] = 1 }; return f17() + q.b.x; }
+int g18(void) { struct box q = { .b = { .x = 18 }, .tag[2] = 1 }; return f18() + q.b.x; }
+int g19(void) { struct box q = { .b = { .x = 19 }, .tag[2] = 1 }; return f19() + q.b.x; }
+int g20(void) { struct box q = { .b = { .x = 20 }, .tag[2] = 1 }; return f20() + q.b.x; }
+int g21(void) { struct box q = { .b = { .x = 21 }, .tag[2] = 1 }; return f21() + q.b.x; }
+int g22(void) { struct box q = { .b = { .x = 22 }, .tag[2] = 1 }; return f22() + q.b.x; }
+int g23(void) { struct box q = { .b = { .x = 23 }, .tag[2] = 1 }; return f23() + q.b.x; }
+int g24(void) { struct box q = { .b = { .x = 24 }, .tag[2] = 1 }; return f24() + q.b.x; }
+int g25(void) { struct box q = { .b = { .x = 25 }, .tag[2] = 1 }; return f25() + q.b.x; }
+int g26(void) { struct box q = { .b = { .x = 26 }, .tag[2] = 1 }; return f26() + q.b.x; }
+int g27(void) { struct box q = { .b = { .x = 27 }, .tag[2] = 1 }; return f27() + q.b.x; }
+int g28(void) { struct box q = { .b = { .x = 28 }, .tag[2] = 1 }; return f28() + q.b.x; }
+int g29(void) { struct box q = { .b = { .x = 29 }, .tag[2] = 1 }; return f29() + q.b.x; }
+int g30(void) { struct box q = { .b = { .x = 30 }, .tag[2] = 1 }; return f30() + q.b.x; }
+int g31(void) { struct box q = { .b = { .x = 31 }, .tag[2] = 1 }; return f31() + q.b.x; }
+int g32(void) { struct box q = { .b = { .x = 32 }, .tag[2] = 1 }; return f32() + q.b.x; }
+int g33(void) { struct box q = { .b = { .x = 33 }, .tag[2] = 1 }; return f33() + q.b.x; }
+int g34(void) { struct box q = { .b = { .x = 34 }, .tag[2] = 1 }; return f34() + q.b.x; }
+int g35(void) { struct box q = { .b = { .x = 35 }, .tag[2] = 1 }; return f35() + q.b.x; }
+int g36(void) { struct box q = { .b = { .x = 36 }, .tag[2] = 1 }; return f36() + q.b.x; }
+int g37(void) { struct box q = { .b = { .x = 37 }, .tag[2] = 1 }; return f37() + q.b.x; }
+int g38(void) { struct box q = { .b = { .x = 38 }, .tag[2] = 1 }; return f38() + q.b.x; }
+int g39(void) { struct box q = { .b = { .x = 39 }, .tag[2] = 1 }; return f39() + q.b.x; }
+int g40(void) { struct box q = { .b = { .x = 40 }, .tag[2] = 1 }; return f40() + q.b.x; }
+int g41(void) { struct box q = { .b = { .x = 41 }, .tag[2] = 1 }; return f41() + q.b.x; }
+int g42(void) { struct box q = { .b = { .x = 42 }, .tag[2] = 1 }; return f42() + q.b.x; }
+int g43(void) { struct box q = { .b = { .x = 43 }, .tag[2] = 1 }; return f43() + q.b.x; }
+int g44(void) { struct box q = { .b = { .x = 44 }, .tag[2] = 1 }; return f44() + q.b.x; }
+int g45(void) { struct box q = { .b = { .x = 45 }, .tag[2] = 1 }; return f45() + q.b.x; }
+int g46(void) { struct box q = { .b = { .x = 46 }, .tag[2] = 1 }; return f46() + q.b.x; }
+int g47(void) { struct box q = { .b = { .x = 47 }, .tag[2] = 1 }; return f47() + q.b.x; }
+int g48(void) { struct box q = { .b = { .x = 48 }, .tag[2] = 1 }; return f48() + q.b.x; }
+int g49(void) { struct box q = { .b = { .x = 49 }, .tag[2] = 1 }; return f49() + q.b.x; }
+}
@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* reads the next constant of an initializer, one per line as
+   "\t[-]constant[f][,]"; returns 'f' for a float, 'd' for a double or 0
+   at the end */
+static int next_constant(FILE *f, double *d, float *x)
+{
+	char line[256];
+	while (fgets(line, sizeof line, f)) {
+		char *end;
+		if (line[0] != '\t')
+			continue;
+		*d = strtod(line, &end);
+		if (end == line)
+			continue;
+		if (*end == 'f') {
+			*x = strtof(line, NULL);
+			return 'f';
+		}
+		return 'd';
+	}
+	return 0;
+}
+
+// the constants of the input and the output read back to the same bits
+int main(int argc, char **argv)
+{
+	if (argc != 3)
+		return 2;
+	FILE *in = fopen(argv[1], "r");
+	FILE *out = fopen(argv[2], "r");
+	if (!in || !out)
+		return 2;
+	long count = 0, bad = 0;
+	for (;;) {
+		double d1, d2;
+		float x1, x2;
+		int k1 = next_constant(in, &d1, &x1);
+		int k2 = next_constant(out, &d2, &x2);
+		if (k1 != k2) {
+			printf("constant %ld: kinds differ\n", count);
+			return 1;
+		}
+		if (!k1)
+			break;
+		if (k1 == 'd' ? memcmp(&d1, &d2, sizeof d1) :
+				memcmp(&x1, &x2, sizeof x1)) {
+			if (bad++ < 10)
+				printf("constant %ld: %.17g printed as %.17g\n", count,
+				       k1 == 'd' ? d1 : x1, k1 == 'd' ? d2 : x2);
+		}
+		count++;
+	}
+	fclose(in);
+	fclose(out);
+	if (bad)
+		printf("%ld of %ld constants changed\n", bad, count);
+	return bad != 0;
+}
@@ -0,0 +1,27 @@
+# 0 "include.c"
+# 0 "<built-in>"
+# 0 "<command-line>"
+# 1 "/usr/include/stdc-predef.h" 1 3 4
+# 0 "<command-line>" 2
+# 1 "include.c"
+# 1 "include.h" 1
+# 1 "system.h" 1 3
+static inline int system_get(void)
+{
+	int hidden;
+	return 1;
+}
+# 2 "include.h" 2
+
+int include_get(void)
+{
+	int shown1;
+	return system_get();
+}
+# 2 "include.c" 2
+
+int main(void)
+{
+	int shown2;
+	return include_get();
+}
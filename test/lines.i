@@ -0,0 +1,22 @@
+# 1 "lines.c"
+typedef struct { void *allocator; } Context;
+int shown(int a)
+{
+	int x = a;
+
+	/* a comment
+	   over lines */
+	int unused1;
+	return x;
+}
+
+static int other(int b)
+{
+	int unused2;
+	return b + 1;
+}
+int main(void)
+{
+	int unused3;
+	return shown(1) + other(2);
+}
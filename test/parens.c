@@ -0,0 +1,33 @@
+#include <stdio.h>
+#include <string.h>
+#include <cast/allocator.h>
+#include <cast/lexer.h>
+#include <cast/parser.h>
+#include <cast/printer.h>
+
+/* parens min|full FILE: prints FILE with as few parentheses as the
+   precedences need, or with the legacy ones around every operand
+   that is not primary */
+int main(int argc, char *argv[])
+{
+	if (argc != 3)
+		return 2;
+	Allocator *a = allocator_new();
+	TextStream *ts = text_stream_new(argv[2]);
+	Lexer *l = lexer_new(ts, a);
+	Parser *p = parser_new(l, a);
+	StmtBLOCK *unit = parse_translation_unit(p);
+	if (!unit) {
+		fprintf(stderr, "%s: syntax error\n", argv[2]);
+		return 1;
+	}
+	Printer *pt = printer_new();
+	printer_set_minimal_parens(pt, strcmp(argv[1], "min") == 0);
+	printer_print_translation_unit(pt, unit);
+	printer_delete(pt);
+	parser_delete(p);
+	lexer_delete(l);
+	text_stream_delete(ts);
+	allocator_delete(a);
+	return 0;
+}
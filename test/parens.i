@@ -0,0 +1,74 @@
+# 1 "parens.c"
+struct s { int m, a[4]; struct s *p; };
+int f(int, ...);
+int g(int x, int y, int z, int *q, struct s *s, struct s v, char **pp)
+{
+	x = y = z;
+	x = (y = z) + 1;
+	x = y ? z : x ? y : z;
+	x = (y ? z : x) ? y : z;
+	x = y ? (z, x) : (x = y);
+	x = (x = y) ? z : y;
+	x = y || z && x;
+	x = (y || z) && x;
+	x = y | z ^ x & y;
+	x = ((y | z) ^ x) & y;
+	x = y == z < x;
+	x = (y == z) < x;
+	x = y << z + x;
+	x = (y << z) + x;
+	x = y - (z - x);
+	x = y - z - x;
+	x = y / (z * x);
+	x = y % z * x;
+	x = -(-y);
+	x = - -y;
+	x = -(--y);
+	x = +(+y) + +(++z);
+	x = !~-y;
+	x = *q++;
+	x = (*q)++;
+	x = *&*q;
+	x = -(int) (char) y;
+	x = (int) -y;
+	x = (int) (y + z);
+	x = (int) *q;
+	x = *(int *) s;
+	x = sizeof (int) * y;
+	x = sizeof y * z;
+	x = sizeof (y * z);
+	x = sizeof ((int) y);
+	x = sizeof ((char) y) + z;
+	x = sizeof (char) + sizeof -y;
+	x = sizeof *q;
+	x = (unsigned long) sizeof y;
+	x = s->p->a[1];
+	x = (*s).p->m;
+	x = (&v)->m;
+	x = *s->p->a;
+	x = (*pp)[1];
+	x = *pp[1];
+	x = (x, y), z;
+	x = f((x, y), z);
+	x = f(x ? y : z, (x = y, z));
+	x = f(0, x = y);
+	x = *(q += y) -= z;
+	x = y += z *= x;
+	x = x < y ? x : y < z ? y : z;
+	x = (x ? y : z) + 1;
+	x = x ? y : (z = x);
+	x = -(x ? y : z);
+	x = (int) (x ? y : z);
+	x = !(x && y);
+	x = &q[1] - &*q;
+	q = &(*s).a[x];
+	x = ((struct s) { 1 }).m;
+	x = (int) { y };
+	return x, y, z;
+}
+int h(int x)
+{
+	int a[] = { (x, 2), 3 ? 4 : 5, -(-6) };
+	int b = (x, 2) ? 3 : 4;
+	return a[b];
+}
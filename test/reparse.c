@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <cast/allocator.h>
+#include <cast/parser.h>
+#include <cast/printer.h>
+
+static const char base[] =
+	"# 1 \"reparse.c\"\n"
+	"typedef int T;\n"
+	"int g;\n"
+	"int f(int a)\n"
+	"{\n"
+	"\tT * b;\n"
+	"\treturn a;\n"
+	"}\n"
+	"int h(void)\n"
+	"{\n"
+	"\tU * c;\n"
+	"\treturn 0;\n"
+	"}\n"
+	"int k(void)\n"
+	"{\n"
+	"\tU * d;\n"
+	"\treturn g;\n"
+	"}\n";
+
+// the printed tree, as a malloc'ed string
+static char *print(StmtBLOCK *tree)
+{
+	FILE *f = tmpfile();
+	int saved = dup(1);
+	fflush(stdout);
+	dup2(fileno(f), 1);
+	Printer *pt = printer_new();
+	printer_print_translation_unit(pt, tree);
+	printer_delete(pt);
+	fflush(stdout);
+	dup2(saved, 1);
+	close(saved);
+	long len = ftell(f);
+	char *s = malloc(len + 1);
+	rewind(f);
+	s[fread(s, 1, len, f)] = 0;
+	fclose(f);
+	return s;
+}
+
+static TextEdit edit(const char *text, const char *from, long len,
+		     const char *to)
+{
+	const char *q = strstr(text, from);
+	return (TextEdit) { q - text, len < 0 ? strlen(from) : len,
+			    to, strlen(to) };
+}
+
+/* applies the edits to u and checks the tree against a fresh parse of
+   the new text, and the number of declarations parsed again unless
+   reparsed is -1 */
+static int check(const char *name, ParsedUnit *u, const TextEdit *edits,
+		 int count, int reparsed, Allocator *a)
+{
+	if (!reparse_unit(u, edits, count)) {
+		printf("%s: syntax error\n", name);
+		return 1;
+	}
+	long len;
+	const char *text = parsed_unit_text(u, &len);
+	ParsedUnit *fresh = parse_unit(text, len, a);
+	char *got = print(parsed_unit_tree(u));
+	char *want = print(parsed_unit_tree(fresh));
+	int bad = 0;
+	if (strcmp(got, want)) {
+		printf("%s: reparsed\n%s\nparsed\n%s\n", name, got, want);
+		bad = 1;
+	} else if (reparsed >= 0 && parsed_unit_reparsed(u) != reparsed) {
+		printf("%s: %d declarations parsed again, not %d\n", name,
+		       parsed_unit_reparsed(u), reparsed);
+		bad = 1;
+	}
+	free(got);
+	free(want);
+	parsed_unit_delete(fresh);
+	return bad;
+}
+
+int main(void)
+{
+	Allocator *a = allocator_new();
+	int bad = 0;
+
+	// each edit on its own
+	ParsedUnit *u = parse_unit(base, strlen(base), a);
+	long len;
+	TextEdit body = edit(base, "return a;", -1, "return a + 1;");
+	bad += check("body", u, &body, 1, 1, a);
+	const char *text = parsed_unit_text(u, &len);
+	// U names a type from here on, in h and k as well
+	TextEdit add = edit(text, "int h(void)", 0, "typedef long U;\n");
+	bad += check("add typedef", u, &add, 1, -1, a);
+	text = parsed_unit_text(u, &len);
+	// T names the variable now, in f as well
+	TextEdit hide = edit(text, "typedef int T;", -1, "int T;");
+	bad += check("hide typedef", u, &hide, 1, -1, a);
+	parsed_unit_delete(u);
+
+	// all at once
+	u = parse_unit(base, strlen(base), a);
+	TextEdit all[] = {
+		edit(base, "typedef int T;", -1, "int T;"),
+		edit(base, "return a;", -1, "return a + 1;"),
+		edit(base, "int h(void)", 0, "typedef long U;\n"),
+	};
+	bad += check("all edits", u, all, 3, -1, a);
+	parsed_unit_delete(u);
+
+	allocator_delete(a);
+	return bad != 0;
+}
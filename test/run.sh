@@ -0,0 +1,181 @@
+#!/bin/sh
+# Runs the tests on the built tree: make boot first.  Helper programs
+# are built from the library sources without the managed rewrite.
+T=$(cd "$(dirname "$0")" && pwd)
+TOP=$(dirname "$T")
+PP=$TOP/src/cast-pp
+CC=${CC:-cc}
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+failed=0
+
+pass() { echo "PASS $1"; }
+fail() { echo "FAIL $1"; failed=1; }
+
+# a helper program from test/NAME.c
+build() {
+	$CC -O1 -w -I"$TOP/include" -I"$TOP/include/cast" -o "$OUT/$1" \
+		"$T/$1.c" "$TOP"/lib/*.c -lpthread
+}
+
+# the output must be accepted by the compiler
+syntax_ok() {
+	$CC -fsyntax-only -w -x c "$1" 2> "$OUT/cc.err"
+}
+
+# a reused tree arena must not leak old fields into designators
+for opt in --cast-stats "--cast-trace=$OUT/trace.json --cast-trace-decls=1"; do
+	name="stream designators $opt"
+	if $PP --stream $opt "$T/designators.i" > "$OUT/d.c" 2> /dev/null &&
+	   syntax_ok "$OUT/d.c"; then
+		pass "$name"
+	else
+		fail "$name"
+	fi
+done
+
+# diagnostics point at the input lines, through the same includes
+warn_lines() {
+	$CC -Wall -fsyntax-only -x c "$1" 2>&1 |
+		grep -o '^\(In file included from \)\?[^ :]*:[0-9][0-9]*' |
+		sed 's|[^ ]*/||'
+}
+for t in lines skim include unnamed; do
+	warn_lines "$T/$t.i" > "$OUT/$t.want"
+	for opt in --compact --stream "--compact --max-tokens=10" \
+		   "--compact --jobs=2"; do
+		name="$t $opt"
+		$PP $opt "$T/$t.i" > "$OUT/$t.i" 2> /dev/null
+		if warn_lines "$OUT/$t.i" | cmp -s - "$OUT/$t.want"; then
+			pass "$name"
+		else
+			fail "$name"
+		fi
+	done
+done
+
+if build align && "$OUT/align"; then
+	pass "allocator alignment"
+else
+	fail "allocator alignment"
+fi
+
+# the tokens of lazy bodies parsed by patch count once against the budget
+for opt in --max-tokens=150 "--stream --max-tokens=150"; do
+	name="managed lazy bodies $opt"
+	if $PP $opt "$T/budget.i" > "$OUT/b.c" 2> /dev/null &&
+	   grep -q '__managed_g(__myctx, a)' "$OUT/b.c" &&
+	   ! grep -q '[^_]g(a)' "$OUT/b.c"; then
+		pass "$name"
+	else
+		fail "$name"
+	fi
+done
+
+# a function returning an expression n terms deep, or a managed one
+# with -m: an || chain, mixed operators, a ?: chain, parenthesized
+# sums or unary operators
+deep() {
+	awk -v n="$1" -v shape="$2" -v managed="$3" 'BEGIN {
+		split("|| && | ^ & == < << + * - / %", ops, " ")
+		printf "# 1 \"deep.c\"\n"
+		printf "typedef struct { void *allocator; } Context;\n"
+		if (managed)
+			printf "__managed {\n"
+		printf "int f(int a)\n{\n\treturn "
+		if (shape == "or" || shape == "mixed") {
+			printf "a"
+			for (i = 1; i < n; i++)
+				printf "%sa", shape == "or" ? "||" : ops[i % 13 + 1]
+		} else if (shape == "cond") {
+			for (i = 1; i < n; i++)
+				printf "a?a:"
+			printf "a"
+		} else if (shape == "parens") {
+			for (i = 1; i < n; i++)
+				printf "(a+"
+			printf "a"
+			for (i = 1; i < n; i++)
+				printf ")"
+		} else if (shape == "unary") {
+			for (i = 1; i < n; i++)
+				printf "-~"
+			printf "a"
+		}
+		printf ";\n}\n"
+		if (managed)
+			printf "}\n"
+	}'
+}
+
+# the parser, elim and the managed rewrite take long chains without
+# recursing
+for n in 1000 10000 100000 1000000; do
+	for shape in or mixed cond; do
+		deep $n $shape > "$OUT/deep.i"
+		if $PP --no-lazy "$OUT/deep.i" > "$OUT/deep.c" 2> "$OUT/deep.err" &&
+		   ! grep -q 'syntax error' "$OUT/deep.err"; then
+			pass "deep $shape $n"
+		else
+			fail "deep $shape $n"
+		fi
+	done
+done
+deep 300000 or -m > "$OUT/deep.i"
+if $PP "$OUT/deep.i" 2> /dev/null | grep -q '__managed_f(Context'; then
+	pass "managed deep chain"
+else
+	fail "managed deep chain"
+fi
+
+# nested operands recurse; past 10000 levels (NEST_MAX in the parser)
+# they are a syntax error and the function passes through
+for shape in parens unary; do
+	deep 200000 $shape > "$OUT/deep.i"
+	if $PP --no-lazy "$OUT/deep.i" > "$OUT/deep.c" 2> "$OUT/deep.err" &&
+	   grep -q 'syntax error, passed through' "$OUT/deep.err" &&
+	   grep -q '^int f(int a)' "$OUT/deep.c"; then
+		pass "deep $shape 200000"
+	else
+		fail "deep $shape 200000"
+	fi
+done
+
+# reparsing after edits gives the tree a fresh parse does
+if build reparse && "$OUT/reparse"; then
+	pass "reparse after edits"
+else
+	fail "reparse after edits"
+fi
+
+# minimal parentheses keep the tree: print, parse again and compare
+# both with a parenthesis around every operand
+if build parens && "$OUT/parens" min "$T/parens.i" > "$OUT/min.c" &&
+   syntax_ok "$OUT/min.c" &&
+   "$OUT/parens" full "$T/parens.i" > "$OUT/want.c" &&
+   "$OUT/parens" full "$OUT/min.c" | cmp -s - "$OUT/want.c"; then
+	pass "minimal parens round trip"
+else
+	fail "minimal parens round trip"
+fi
+
+# an initializer of 1M doubles and 250k floats, over the whole range
+# and down into the subnormals, reads back to the same values
+awk 'BEGIN {
+	srand(1)
+	printf "# 1 \"floats.c\"\ndouble d[] = {\n"
+	for (i = 0; i < 1000000; i++)
+		printf "\t%.17g,\n", (rand() - 0.5) * 10 ^ int(rand() * 630 - 322)
+	printf "};\nfloat f[] = {\n"
+	for (i = 0; i < 250000; i++)
+		printf "\t%.8ef,\n", (rand() - 0.5) * 10 ^ int(rand() * 84 - 45)
+	printf "};\n"
+}' > "$OUT/floats.i"
+if build floats && $PP "$OUT/floats.i" > "$OUT/floats.c" 2> /dev/null &&
+   "$OUT/floats" "$OUT/floats.i" "$OUT/floats.c"; then
+	pass "float constants round trip"
+else
+	fail "float constants round trip"
+fi
+
+exit $failed
@@ -0,0 +1,17 @@
+# 1 "skim.c"
+# 1 "skim.h" 1 3
+extern int f(int a,
+
+	     no_such_type b);
+struct s {
+	int a;
+
+	no_such_type c;
+};
+# 2 "skim.c" 2
+int main(void)
+{
+	int unused;
+	struct s v;
+	return f(0, 0);
+}
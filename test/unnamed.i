@@ -0,0 +1,22 @@
+int global;
+
+
+int first(void)
+{
+	int shown1;
+	return 0;
+}
+
+
+
+static int second(int a)
+{
+
+	int shown2;
+	return a;
+}
+int main(void)
+{
+	int shown3;
+	return first() + second(1);
+}